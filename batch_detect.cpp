@@ -0,0 +1,606 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+// batch_detect — Runs the detection pipeline on many videos at once, headless,
+// on one shared work-stealing thread pool.
+//
+// Every video is a stream with two strands: the reader strand decodes, gates
+// and detects frames in order (MOG2 is sequential), and the classifier strand
+// classifies, writes CSV rows and updates the heatmap in frame order (team
+// anchors and tracking are sequential). Jersey feature extraction has no
+// state and runs as free tasks in between, so one long video can still use
+// several cores. A stream keeps at most a few frames in flight; idle workers
+// steal from busy ones, so cores stay busy whichever stream has work.
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "player_detection.h"
+#include "team_classification.h"
+#include "player_heatmap.h"
+#include "frame_gate.h"
+#include "stage_cache.h"
+#include "frame_pool.h"
+#include "memory_report.h"
+#include "work_stealing_pool.h"
+
+typedef std::chrono::steady_clock BatchClock;
+
+struct BatchSettings {
+    int workers;
+    int opencvThreads;
+    int maxActiveStreams;
+    int framesInFlight;        // per stream, bounds memory and keeps streams fair
+    bool gateEnabled;
+    DetectorParams detectorParams;
+    double heatmapScale;
+};
+
+// One decoded frame on its way through a stream. The image is a slot of the
+// stream's frame pool, written by the reader and read-only afterwards.
+struct FrameWork {
+    int frameIndex;
+    FrameRef frame;
+    DetectionRecord detection;
+    std::vector<cv::Vec3f> features;
+};
+
+// TaskTimer — Adds the lifetime of the enclosing task to a stream's busy time.
+class TaskTimer {
+    std::atomic<long long> &total;
+    BatchClock::time_point start;
+
+public:
+    explicit TaskTimer(std::atomic<long long> &busyNanoseconds) : total(busyNanoseconds), start(BatchClock::now()) {}
+    ~TaskTimer(){
+        total += std::chrono::duration_cast<std::chrono::nanoseconds>(BatchClock::now() - start).count();
+    }
+};
+
+// StreamJob — Pipeline state of one video. Reader state is only touched on
+// readStrand, classifier state only on classifyStrand; the counters that
+// couple the two are guarded by progressMutex.
+class StreamJob {
+    WorkStealingPool &pool;
+    const BatchSettings &settings;
+    Strand readStrand;
+    Strand classifyStrand;
+    std::function<void()> onFinished;
+
+    // Reader strand. The pool has a slot per frame in flight, so acquiring
+    // one never blocks a worker; its exhaustion count shows if that breaks.
+    FramePool framePool;
+    cv::VideoCapture capture;
+    cv::Ptr<cv::BackgroundSubtractor> bgSubtractor;
+    FrameGate frameGate;
+    int framesSinceReset;
+    bool backgroundStale;
+    int nextFrameIndex;
+
+    // Classifier strand.
+    std::map<int, std::shared_ptr<FrameWork> > readyFrames;
+    int nextToClassify;
+    TeamClassifierState teamState;
+    Heatmap heatmap;
+    std::ofstream detectionCsv;
+    std::ofstream skippedCsv;
+    int skippedRangeStart;
+    MemoryReport memory;
+
+    std::mutex progressMutex;
+    int framesRead;
+    int framesDone;
+    int framesInFlight;
+    bool inputEnded;
+    bool readerPaused;
+    bool failed;
+    std::string errorMessage;
+
+    void readNext();
+    void extractFeatures(const std::shared_ptr<FrameWork> &work);
+    void classifyInOrder(const std::shared_ptr<FrameWork> &work);
+    void processFrame(FrameWork &work);
+    void recordMemoryUsage(cv::Size frameSize);
+    void frameDone();
+    void finish();
+    void fail(const std::string &message);
+
+public:
+    std::string name;
+    std::string videoPath;
+    std::string outputDir;
+
+    // Reporting, readable from any thread.
+    std::atomic<long long> busyNanoseconds;
+    std::atomic<int> framesProcessed;
+    std::atomic<int> framesSkipped;
+    std::atomic<long> playersFound;
+    BatchClock::time_point startTime;
+    BatchClock::time_point endTime;
+    std::atomic<bool> finished;
+
+    StreamJob(WorkStealingPool &workerPool, const BatchSettings &batchSettings, const std::string &path,
+              const std::string &outDir, const std::string &jobName);
+    void start(std::function<void()> finishedCallback);
+    bool succeeded();
+    std::string error();
+    const FramePool &frames() const { return framePool; }
+    // Classifier-strand state: read only once the job has finished.
+    const MemoryReport &memoryUsage() const { return memory; }
+};
+
+StreamJob::StreamJob(WorkStealingPool &workerPool, const BatchSettings &batchSettings, const std::string &path,
+                     const std::string &outDir, const std::string &jobName)
+    : pool(workerPool), settings(batchSettings), readStrand(workerPool), classifyStrand(workerPool),
+      framePool(jobName, batchSettings.framesInFlight + 1), framesSinceReset(0), backgroundStale(false),
+      nextFrameIndex(0), nextToClassify(0), heatmap(batchSettings.heatmapScale), skippedRangeStart(-1),
+      framesRead(0), framesDone(0), framesInFlight(0), inputEnded(false), readerPaused(false), failed(false),
+      name(jobName), videoPath(path), outputDir(outDir), busyNanoseconds(0), framesProcessed(0),
+      framesSkipped(0), playersFound(0), finished(false) {}
+
+void StreamJob::start(std::function<void()> finishedCallback){
+    onFinished = finishedCallback;
+    startTime = BatchClock::now();
+    readStrand.post([this]{
+        TaskTimer timer(busyNanoseconds);
+        std::error_code dirError;
+        std::filesystem::create_directories(outputDir, dirError);
+        detectionCsv.open(outputDir + "/ours.csv");
+        skippedCsv.open(outputDir + "/skipped_frames.csv");
+        if(!detectionCsv.is_open() || !skippedCsv.is_open()) fail("cannot write to " + outputDir);
+        else if(!capture.open(videoPath)) fail("cannot open video");
+        else {
+            cv::Size frameSize((int)capture.get(cv::CAP_PROP_FRAME_WIDTH), (int)capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+            if(frameSize.area() > 0) framePool.preallocate(frameSize, CV_8UC3);
+            detectionCsv << "frame,x1,y1,x2,y2,team\n";
+            skippedCsv << "first_frame,last_frame\n";
+            bgSubtractor = createBackgroundModel(settings.detectorParams);
+        }
+        readStrand.post([this]{ readNext(); });
+    });
+}
+
+void StreamJob::fail(const std::string &message){
+    std::lock_guard<std::mutex> lock(progressMutex);
+    if(!failed) errorMessage = message;
+    failed = true;
+}
+
+bool StreamJob::succeeded(){
+    std::lock_guard<std::mutex> lock(progressMutex);
+    return !failed;
+}
+
+std::string StreamJob::error(){
+    std::lock_guard<std::mutex> lock(progressMutex);
+    return errorMessage;
+}
+
+// readNext — Reader strand: decode, gate and detect one frame, then hand it
+// on and re-post itself. Pauses while the stream has too many frames in
+// flight; frameDone() resumes it.
+void StreamJob::readNext(){
+    TaskTimer timer(busyNanoseconds);
+    bool stopReading;
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        if(inputEnded) return;
+        if(!failed && framesInFlight >= settings.framesInFlight){
+            readerPaused = true;
+            return;
+        }
+        stopReading = failed;
+        if(!stopReading) framesInFlight++;
+    }
+
+    std::shared_ptr<FrameWork> work(new FrameWork());
+    bool haveFrame = false;
+    if(!stopReading){
+        try {
+            work->frame = framePool.acquire();
+            haveFrame = capture.read(work->frame.image());
+            if(haveFrame){
+                const cv::Mat &frame = work->frame.image();
+                work->frameIndex = nextFrameIndex++;
+                DetectionRecord &detection = work->detection;
+                if(settings.gateEnabled){
+                    GateDecision gate = frameGate.evaluate(frame);
+                    detection.shotCut = gate.isShotCut;
+                    detection.skipped = !gate.isPitch;
+                    if(gate.isShotCut || !gate.isPitch) backgroundStale = true;
+                    if(gate.isPitch && backgroundStale){
+                        bgSubtractor = createBackgroundModel(settings.detectorParams);
+                        framesSinceReset = 0;
+                        backgroundStale = false;
+                        detection.trackingReset = true;
+                    }
+                }
+                if(!detection.skipped){
+                    detection.boxes = detectPlayers(frame, bgSubtractor,
+                                                    backgroundLearningRate(framesSinceReset, settings.gateEnabled),
+                                                    settings.detectorParams);
+                    framesSinceReset++;
+                }
+            }
+        } catch(const cv::Exception &e){
+            fail(std::string("frame ") + std::to_string(nextFrameIndex) + ": " + e.what());
+            haveFrame = false;
+        }
+    }
+
+    // End of video or failure: nothing more is read; whichever of the reader
+    // and the classifier sees the last frame done posts finish().
+    if(!haveFrame){
+        bool allDone;
+        {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            if(!stopReading) framesInFlight--;
+            inputEnded = true;
+            allDone = framesDone == framesRead;
+        }
+        capture.release();
+        if(allDone) classifyStrand.post([this]{ finish(); });
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        framesRead++;
+    }
+    if(work->detection.skipped){
+        classifyStrand.post([this, work]{ classifyInOrder(work); });
+    } else {
+        pool.submit([this, work]{ extractFeatures(work); });
+    }
+    readStrand.post([this]{ readNext(); });
+}
+
+// extractFeatures — Stateless, runs on any worker, possibly out of order.
+void StreamJob::extractFeatures(const std::shared_ptr<FrameWork> &work){
+    {
+        TaskTimer timer(busyNanoseconds);
+        try {
+            work->features = extractPlayerFeatures(work->frame.image(), work->detection.boxes, settings.detectorParams);
+        } catch(const cv::Exception &e){
+            fail(std::string("features: ") + e.what());
+        }
+    }
+    classifyStrand.post([this, work]{ classifyInOrder(work); });
+}
+
+// classifyInOrder — Classifier strand: frames arrive in any order and are
+// processed strictly by frame index.
+void StreamJob::classifyInOrder(const std::shared_ptr<FrameWork> &work){
+    TaskTimer timer(busyNanoseconds);
+    readyFrames[work->frameIndex] = work;
+    while(!readyFrames.empty() && readyFrames.begin()->first == nextToClassify){
+        std::shared_ptr<FrameWork> next = readyFrames.begin()->second;
+        readyFrames.erase(readyFrames.begin());
+        nextToClassify++;
+        if(succeeded()){
+            try {
+                processFrame(*next);
+            } catch(const cv::Exception &e){
+                fail(std::string("frame ") + std::to_string(next->frameIndex) + ": " + e.what());
+            }
+        }
+        // Free the slot before the reader can be resumed for the next frame.
+        next->frame.reset();
+        frameDone();
+    }
+}
+
+// processFrame — Same per-frame outputs as detect: CSV rows, skipped ranges,
+// tracking resets and the heatmap.
+void StreamJob::processFrame(FrameWork &work){
+    if(work.detection.skipped){
+        if(skippedRangeStart < 0) skippedRangeStart = work.frameIndex;
+        framesSkipped++;
+        return;
+    }
+    if(skippedRangeStart >= 0){
+        skippedCsv << skippedRangeStart << "," << (work.frameIndex - 1) << "\n";
+        skippedRangeStart = -1;
+    }
+    if(work.detection.trackingReset) resetPlayerTracking(teamState);
+
+    std::vector<std::pair<cv::Rect,int> > classifiedPlayers =
+        classifyPlayerFeatures(work.detection.boxes, work.features, teamState);
+    for(size_t i = 0; i < classifiedPlayers.size(); i++){
+        cv::Rect box = classifiedPlayers[i].first;
+        detectionCsv << work.frameIndex << ","
+                     << box.x << "," << box.y << ","
+                     << (box.x + box.width) << "," << (box.y + box.height) << ","
+                     << classifiedPlayers[i].second << "\n";
+    }
+    heatmap.update(work.frame.image(), classifiedPlayers);
+    if(framesProcessed % 100 == 0) recordMemoryUsage(work.frame.image().size());
+    framesProcessed++;
+    playersFound += (long)classifiedPlayers.size();
+}
+
+// recordMemoryUsage — Classifier strand: footprint of this stream by component.
+void StreamJob::recordMemoryUsage(cv::Size frameSize){
+    memory.record("frame pool", framePool.bytesAllocated());
+    memory.recordEstimate("background model", backgroundModelBytes(settings.detectorParams, frameSize));
+    memory.recordEstimate("detection scratch", detectionScratchBytes(settings.detectorParams, frameSize));
+    memory.record("heatmap", heatmap.memoryBytes());
+}
+
+void StreamJob::frameDone(){
+    bool resumeReader, allDone;
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        framesDone++;
+        framesInFlight--;
+        resumeReader = readerPaused;
+        readerPaused = false;
+        allDone = inputEnded && framesDone == framesRead;
+    }
+    if(resumeReader) readStrand.post([this]{ readNext(); });
+    if(allDone) finish();
+}
+
+// finish — Classifier strand, once: close outputs and save the heatmap.
+void StreamJob::finish(){
+    TaskTimer timer(busyNanoseconds);
+    if(skippedRangeStart >= 0){
+        skippedCsv << skippedRangeStart << "," << (nextToClassify - 1) << "\n";
+        skippedRangeStart = -1;
+    }
+    detectionCsv.close();
+    skippedCsv.close();
+    if(succeeded()) heatmap.save(outputDir + "/");
+    endTime = BatchClock::now();
+    finished = true;
+    if(onFinished) onFinished();
+}
+
+// readJobList — One video per line, optionally followed by an output
+// directory; blank lines and lines starting with '#' are ignored. Videos
+// without a directory get <outRoot>/<file stem>, made unique.
+static bool readJobList(const std::string &path, const std::string &outRoot,
+                        std::vector<std::pair<std::string, std::string> > &jobs){
+    std::ifstream in(path.c_str());
+    if(!in.is_open()) return false;
+    std::set<std::string> usedDirs;
+    std::string line;
+    while(std::getline(in, line)){
+        if(!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        std::istringstream fields(line);
+        std::string video, outDir;
+        if(!(fields >> video) || video[0] == '#') continue;
+        if(!(fields >> outDir)){
+            std::string stem = std::filesystem::path(video).stem().string();
+            outDir = outRoot + "/" + stem;
+            for(int suffix = 2; usedDirs.count(outDir); suffix++)
+                outDir = outRoot + "/" + stem + "_" + std::to_string(suffix);
+        }
+        usedDirs.insert(outDir);
+        jobs.push_back(std::make_pair(video, outDir));
+    }
+    return true;
+}
+
+int main(int argc, char **argv){
+    std::string jobListPath;
+    std::string outRoot = "batch_out";
+    std::string profileName = Broadcast1080p::name;
+    std::string detectorParamsPath;
+    int reportEverySeconds = 10;
+    int decodeThreads = -1;
+    BatchSettings settings;
+    settings.workers = std::max(1u, std::thread::hardware_concurrency());
+    settings.opencvThreads = -1;
+    settings.maxActiveStreams = -1;
+    settings.framesInFlight = -1;
+    settings.gateEnabled = true;
+    settings.heatmapScale = 1.0;
+    bool lowMemory = false;
+
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--threads" && hasValue) settings.workers = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--opencv-threads" && hasValue) settings.opencvThreads = std::max(0, std::atoi(argv[++i]));
+        else if(arg == "--decode-threads" && hasValue) decodeThreads = std::max(0, std::atoi(argv[++i]));
+        else if(arg == "--max-active" && hasValue) settings.maxActiveStreams = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--in-flight" && hasValue) settings.framesInFlight = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--out" && hasValue) outRoot = argv[++i];
+        else if(arg == "--profile" && hasValue) profileName = argv[++i];
+        else if(arg == "--detector-params" && hasValue) detectorParamsPath = argv[++i];
+        else if(arg == "--report-every" && hasValue) reportEverySeconds = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--no-gate") settings.gateEnabled = false;
+        else if(arg == "--low-memory") lowMemory = true;
+        else if(jobListPath.empty() && arg.compare(0, 2, "--") != 0) jobListPath = arg;
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            jobListPath.clear();
+            break;
+        }
+    }
+    if(jobListPath.empty()){
+        std::cerr << "Usage: " << argv[0] << " <jobs.txt> [--threads N] [--opencv-threads N] [--decode-threads N]\n"
+                  << "       [--max-active N] [--in-flight N] [--out <dir>] [--profile <name>]\n"
+                  << "       [--detector-params <file.yml>] [--report-every <s>] [--no-gate] [--low-memory]\n"
+                  << "jobs.txt: one '<video> [output_dir]' per line\n";
+        return -1;
+    }
+
+    if(!findDetectorProfile(profileName, settings.detectorParams)){
+        std::cerr << "Error: unknown profile " << profileName << "\n";
+        return -1;
+    }
+    if(!detectorParamsPath.empty() && !loadDetectorParams(detectorParamsPath, settings.detectorParams)){
+        std::cerr << "Error: could not read detector parameters " << detectorParamsPath << "\n";
+        return -1;
+    }
+    settings.detectorParams.debugViews = false;
+    if(lowMemory){
+        applyLowMemorySettings(settings.detectorParams);
+        settings.heatmapScale = LOW_MEMORY_HEATMAP_SCALE;
+    }
+    if(settings.framesInFlight < 0) settings.framesInFlight = lowMemory ? 2 : 4;
+
+    std::vector<std::pair<std::string, std::string> > jobSpecs;
+    if(!readJobList(jobListPath, outRoot, jobSpecs)){
+        std::cerr << "Error: could not read job list " << jobListPath << "\n";
+        return -1;
+    }
+    if(jobSpecs.empty()){
+        std::cerr << "Error: no jobs in " << jobListPath << "\n";
+        return -1;
+    }
+
+    // With several workers the pool owns the cores: OpenCV's own parallel
+    // loops and FFmpeg's decoder threads would otherwise multiply the thread
+    // count by the number of streams, so both default to 1. A single worker
+    // leaves the cores idle between its tasks, so OpenCV and FFmpeg keep
+    // their own threading there.
+    if(settings.opencvThreads >= 0) cv::setNumThreads(settings.opencvThreads);
+    else if(settings.workers > 1) cv::setNumThreads(1);
+    bool decodeThreadsGiven = decodeThreads >= 0;
+    if(!decodeThreadsGiven) decodeThreads = settings.workers > 1 ? 1 : 0;
+    if(decodeThreads > 0){
+        std::string captureOptions = "threads;" + std::to_string(decodeThreads);
+        const char *existing = std::getenv("OPENCV_FFMPEG_CAPTURE_OPTIONS");
+        if(existing && *existing){
+            if(decodeThreadsGiven){
+                // Keep the other options; FFmpeg applies the later "threads" entry.
+                captureOptions = std::string(existing) + "|" + captureOptions;
+            } else {
+                std::cerr << "Note: using OPENCV_FFMPEG_CAPTURE_OPTIONS=" << existing
+                          << " from the environment instead of 1 decode thread per stream\n";
+                captureOptions = existing;
+            }
+        }
+        setenv("OPENCV_FFMPEG_CAPTURE_OPTIONS", captureOptions.c_str(), 1);
+    }
+    if(settings.maxActiveStreams < 0) settings.maxActiveStreams = settings.workers;
+
+    std::cout << jobSpecs.size() << " jobs, " << settings.workers << " workers, "
+              << settings.maxActiveStreams << " active streams, OpenCV threads "
+              << cv::getNumThreads() << ", profile " << settings.detectorParams.name << "\n";
+
+    // Jobs outlive the pool: tasks still reference them until the workers join.
+    std::vector<std::unique_ptr<StreamJob> > jobs;
+    std::mutex doneMutex;
+    std::condition_variable jobFinished;
+    size_t finishedCount = 0;
+    BatchClock::time_point batchStart = BatchClock::now();
+    double busyAtLastReport = 0.0;
+    int framesAtLastReport = 0;
+    BatchClock::time_point lastReport = batchStart;
+    {
+        WorkStealingPool pool(settings.workers);
+        for(size_t i = 0; i < jobSpecs.size(); i++){
+            std::string name = std::filesystem::path(jobSpecs[i].first).filename().string();
+            jobs.emplace_back(new StreamJob(pool, settings, jobSpecs[i].first, jobSpecs[i].second, name));
+        }
+
+        std::function<void()> notifyFinished = [&]{
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                finishedCount++;
+            }
+            jobFinished.notify_one();
+        };
+
+        // Admit streams up to the active limit; start another whenever one
+        // finishes. Progress is printed from this thread.
+        size_t started = 0;
+        std::unique_lock<std::mutex> lock(doneMutex);
+        while(finishedCount < jobs.size()){
+            while(started < jobs.size() && (int)(started - finishedCount) < settings.maxActiveStreams){
+                std::cout << "Starting " << jobs[started]->name << " -> " << jobs[started]->outputDir << "\n";
+                jobs[started]->start(notifyFinished);
+                started++;
+            }
+            size_t finishedBefore = finishedCount;
+            jobFinished.wait_for(lock, std::chrono::seconds(reportEverySeconds),
+                                 [&]{ return finishedCount != finishedBefore; });
+
+            BatchClock::time_point now = BatchClock::now();
+            if(now - lastReport >= std::chrono::seconds(reportEverySeconds)){
+                int frames = 0;
+                for(size_t i = 0; i < jobs.size(); i++)
+                    frames += jobs[i]->framesProcessed + jobs[i]->framesSkipped;
+                double windowSeconds = std::chrono::duration<double>(now - lastReport).count();
+                double busy = pool.busySeconds();
+                size_t residentBytes = 0, peakResidentBytes = 0;
+                readProcessMemory(residentBytes, peakResidentBytes);
+                std::printf("[%6.0fs] %zu/%zu jobs done, %.1f frames/s, utilization %.0f%%, %.0f MiB resident\n",
+                            std::chrono::duration<double>(now - batchStart).count(), finishedCount, jobs.size(),
+                            (frames - framesAtLastReport) / windowSeconds,
+                            100.0 * (busy - busyAtLastReport) / (windowSeconds * pool.workerCount()),
+                            residentBytes / (1024.0 * 1024.0));
+                std::fflush(stdout);
+                framesAtLastReport = frames;
+                busyAtLastReport = busy;
+                lastReport = now;
+            }
+        }
+        lock.unlock();
+
+        double wallSeconds = std::chrono::duration<double>(BatchClock::now() - batchStart).count();
+        long totalFrames = 0, totalPlayers = 0, totalPoolWaits = 0;
+        size_t frameBufferBytes = 0;
+        int failures = 0;
+        size_t largestJob = 0;
+        std::printf("\n%-32s %8s %8s %9s %9s %9s %10s %8s  %s\n", "job", "frames", "skipped", "wall s", "frames/s",
+                    "busy s", "pool waits", "est MiB", "status");
+        for(size_t i = 0; i < jobs.size(); i++){
+            StreamJob &job = *jobs[i];
+            int frames = job.framesProcessed + job.framesSkipped;
+            double jobWall = std::chrono::duration<double>(job.endTime - job.startTime).count();
+            std::string status = job.succeeded() ? "ok" : "FAILED: " + job.error();
+            if(!job.succeeded()) failures++;
+            std::printf("%-32s %8d %8d %9.1f %9.1f %9.1f %10ld %8.1f  %s\n", job.name.c_str(), frames,
+                        (int)job.framesSkipped, jobWall, jobWall > 0 ? frames / jobWall : 0.0,
+                        job.busyNanoseconds * 1e-9, job.frames().exhaustedCount(),
+                        job.memoryUsage().peakTotal() / (1024.0 * 1024.0), status.c_str());
+            if(job.memoryUsage().peakTotal() > jobs[largestJob]->memoryUsage().peakTotal()) largestJob = i;
+            totalFrames += frames;
+            totalPlayers += job.playersFound;
+            totalPoolWaits += job.frames().exhaustedCount();
+            frameBufferBytes += job.frames().bytesAllocated();
+        }
+        std::printf("\nTotal: %ld frames, %ld players in %.1f s = %.1f frames/s; "
+                    "%d workers %.0f%% utilized, %ld tasks, %ld stolen\n",
+                    totalFrames, totalPlayers, wallSeconds, wallSeconds > 0 ? totalFrames / wallSeconds : 0.0,
+                    pool.workerCount(), 100.0 * pool.busySeconds() / (wallSeconds * pool.workerCount()),
+                    pool.taskCount(), pool.stealCount());
+        std::printf("Frame pools: %.1f MiB of frame buffers, exhausted %ld times\n",
+                    frameBufferBytes / (1024.0 * 1024.0), totalPoolWaits);
+
+        // Per-stream estimate of the largest job; with --max-active streams
+        // open at once, that many times this plus shared scratch is the
+        // budget to plan a node for.
+        std::fflush(stdout);
+        std::cout << "Memory per stream (" << jobs[largestJob]->name << ", per component):\n";
+        jobs[largestJob]->memoryUsage().print(std::cout);
+        printProcessMemory(std::cout);
+        std::cout.flush();
+        if(failures) std::printf("%d of %zu jobs failed\n", failures, jobs.size());
+        return failures ? 1 : 0;
+    }
+}
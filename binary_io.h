@@ -0,0 +1,104 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <opencv2/opencv.hpp>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Native-endian binary helpers for the pipeline's own state files. Values are
+// written raw, cv::Mat as (rows, cols, type) followed by its pixel data, or by
+// a losslessly compressed copy of it for large images.
+
+template<typename T>
+inline void writeBinary(std::ostream &out, const T &value){
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+inline bool readBinary(std::istream &in, T &value){
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return (bool)in;
+}
+
+inline void writeString(std::ostream &out, const std::string &text){
+    writeBinary(out, (int)text.size());
+    out.write(text.data(), (std::streamsize)text.size());
+}
+
+inline bool readString(std::istream &in, std::string &text){
+    int length = 0;
+    if(!readBinary(in, length) || length < 0) return false;
+    text.resize(length);
+    in.read(&text[0], length);
+    return (bool)in;
+}
+
+inline void writeMat(std::ostream &out, const cv::Mat &mat){
+    writeBinary(out, mat.rows);
+    writeBinary(out, mat.cols);
+    writeBinary(out, mat.type());
+    size_t rowBytes = mat.cols * mat.elemSize();
+    for(int r = 0; r < mat.rows; r++)
+        out.write(reinterpret_cast<const char*>(mat.ptr(r)), (std::streamsize)rowBytes);
+}
+
+inline bool readMat(std::istream &in, cv::Mat &mat){
+    int rows = 0, cols = 0, type = 0;
+    if(!readBinary(in, rows) || !readBinary(in, cols) || !readBinary(in, type)) return false;
+    if(rows <= 0 || cols <= 0){
+        mat.release();
+        return true;
+    }
+    mat.create(rows, cols, type);
+    in.read(reinterpret_cast<char*>(mat.data), (std::streamsize)(mat.total() * mat.elemSize()));
+    return (bool)in;
+}
+
+// writeCompressedMat — For Mats of 4-byte elements (CV_32F, CV_32S). The
+// bytes of each element are stored as one 8-bit RGBA pixel of a PNG, so the
+// filter predicts every byte from the same byte of the previous element and
+// deflate sees runs of near-identical exponents. Bit-exact round trip.
+inline void writeCompressedMat(std::ostream &out, const cv::Mat &mat){
+    writeBinary(out, mat.rows);
+    writeBinary(out, mat.cols);
+    writeBinary(out, mat.type());
+    if(mat.empty()) return;
+    CV_Assert(mat.elemSize1() == 4);
+    cv::Mat elementBytes(mat.rows, mat.cols * mat.channels(), CV_8UC4, const_cast<uchar*>(mat.data), mat.step);
+    std::vector<uchar> encoded;
+    cv::imencode(".png", elementBytes, encoded, std::vector<int>{cv::IMWRITE_PNG_COMPRESSION, 3});
+    writeBinary(out, (long long)encoded.size());
+    out.write(reinterpret_cast<const char*>(encoded.data()), (std::streamsize)encoded.size());
+}
+
+inline bool readCompressedMat(std::istream &in, cv::Mat &mat){
+    int rows = 0, cols = 0, type = 0;
+    if(!readBinary(in, rows) || !readBinary(in, cols) || !readBinary(in, type)) return false;
+    if(rows <= 0 || cols <= 0){
+        mat.release();
+        return true;
+    }
+    long long encodedBytes = 0;
+    if(!readBinary(in, encodedBytes) || encodedBytes <= 0) return false;
+    std::vector<uchar> encoded((size_t)encodedBytes);
+    in.read(reinterpret_cast<char*>(encoded.data()), (std::streamsize)encodedBytes);
+    if(!in) return false;
+
+    cv::Mat elementBytes = cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+    if(elementBytes.type() != CV_8UC4 || elementBytes.rows != rows
+       || elementBytes.cols != cols * CV_MAT_CN(type)) return false;
+    cv::Mat(rows, cols, type, elementBytes.data, elementBytes.step).copyTo(mat);
+    return true;
+}
+
+#endif
@@ -0,0 +1,130 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "checkpoint.h"
+#include "binary_io.h"
+#include <cstdio>
+#include <fstream>
+
+static const char CHECKPOINT_MAGIC[4] = {'S', 'V', 'C', 'K'};
+static const int CHECKPOINT_VERSION = 3;
+
+// heatmapFramePath — Where the heatmap's first frame is kept for a checkpoint.
+static std::string heatmapFramePath(const std::string &path){
+    return path + ".heatmap.png";
+}
+
+static void writeClassifierState(std::ostream &out, const TeamClassifierState &state){
+    writeBinary(out, (int)state.teamFeatureAnchors.size());
+    for(size_t i = 0; i < state.teamFeatureAnchors.size(); i++)
+        writeMat(out, state.teamFeatureAnchors[i]);
+    writeBinary(out, state.anchorFrameCount);
+    writeBinary(out, state.teamAnchorsInitialized);
+
+    writeBinary(out, (int)state.previousFrameBoxes.size());
+    for(std::map<int, std::pair<cv::Rect,int> >::const_iterator it = state.previousFrameBoxes.begin();
+        it != state.previousFrameBoxes.end(); ++it){
+        writeBinary(out, it->first);
+        writeBinary(out, it->second.first);
+        writeBinary(out, it->second.second);
+    }
+    writeBinary(out, state.nextTrackingID);
+    writeBinary(out, state.rngState);
+}
+
+static bool readClassifierState(std::istream &in, TeamClassifierState &state){
+    int anchorCount = 0;
+    if(!readBinary(in, anchorCount) || anchorCount < 0) return false;
+    state.teamFeatureAnchors.assign(anchorCount, cv::Mat());
+    for(int i = 0; i < anchorCount; i++)
+        if(!readMat(in, state.teamFeatureAnchors[i])) return false;
+    if(!readBinary(in, state.anchorFrameCount) || !readBinary(in, state.teamAnchorsInitialized)) return false;
+
+    int trackedCount = 0;
+    if(!readBinary(in, trackedCount) || trackedCount < 0) return false;
+    state.previousFrameBoxes.clear();
+    for(int i = 0; i < trackedCount; i++){
+        int trackId = 0, teamLabel = 0;
+        cv::Rect box;
+        if(!readBinary(in, trackId) || !readBinary(in, box) || !readBinary(in, teamLabel)) return false;
+        state.previousFrameBoxes[trackId] = std::make_pair(box, teamLabel);
+    }
+    return readBinary(in, state.nextTrackingID) && readBinary(in, state.rngState);
+}
+
+// saveCheckpointHeatmapFrame — Once per run, as soon as the heatmap has its
+// first frame and before any checkpoint that needs it. Atomic like the
+// checkpoint itself.
+bool saveCheckpointHeatmapFrame(const std::string &path, const Heatmap &heatmap){
+    std::string temporaryPath = path + ".heatmap.tmp.png";
+    return heatmap.saveFirstFrame(temporaryPath)
+        && std::rename(temporaryPath.c_str(), heatmapFramePath(path).c_str()) == 0;
+}
+
+// saveCheckpoint — Written to a temporary file first and renamed over the
+// previous checkpoint, so a crash while saving never leaves a torn file.
+bool saveCheckpoint(const std::string &path, const PipelineProgress &progress, const FrameGate &frameGate,
+                    const TeamClassifierState &teamState, const Heatmap &heatmap){
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) return false;
+
+        out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        writeBinary(out, CHECKPOINT_VERSION);
+        writeString(out, progress.videoPath);
+        writeString(out, progress.detectorSignature);
+        writeBinary(out, progress.gateEnabled);
+        writeBinary(out, progress.nextFrameIndex);
+        writeBinary(out, progress.backgroundEpochStart);
+        writeBinary(out, progress.framesSinceReset);
+        writeBinary(out, progress.backgroundStale);
+        writeBinary(out, progress.skippedRangeStart);
+        writeBinary(out, progress.skippedFrameCount);
+        writeBinary(out, progress.shotCutCount);
+        writeBinary(out, progress.detectionCsvBytes);
+        writeBinary(out, progress.skippedCsvBytes);
+
+        frameGate.saveState(out);
+        writeClassifierState(out, teamState);
+        heatmap.saveState(out);
+
+        out.flush();
+        if(!out) return false;
+    }
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool loadCheckpoint(const std::string &path, PipelineProgress &progress, FrameGate &frameGate,
+                    TeamClassifierState &teamState, Heatmap &heatmap){
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if(!in.is_open()) return false;
+
+    char magic[4];
+    int version = 0;
+    in.read(magic, sizeof(magic));
+    if(!in || !std::equal(magic, magic + 4, CHECKPOINT_MAGIC)) return false;
+    if(!readBinary(in, version) || version != CHECKPOINT_VERSION) return false;
+
+    return readString(in, progress.videoPath)
+        && readString(in, progress.detectorSignature)
+        && readBinary(in, progress.gateEnabled)
+        && readBinary(in, progress.nextFrameIndex)
+        && readBinary(in, progress.backgroundEpochStart)
+        && readBinary(in, progress.framesSinceReset)
+        && readBinary(in, progress.backgroundStale)
+        && readBinary(in, progress.skippedRangeStart)
+        && readBinary(in, progress.skippedFrameCount)
+        && readBinary(in, progress.shotCutCount)
+        && readBinary(in, progress.detectionCsvBytes)
+        && readBinary(in, progress.skippedCsvBytes)
+        && frameGate.loadState(in)
+        && readClassifierState(in, teamState)
+        && heatmap.loadState(in)
+        && heatmap.loadFirstFrame(heatmapFramePath(path));
+}
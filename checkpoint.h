@@ -0,0 +1,52 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include "frame_gate.h"
+#include "player_heatmap.h"
+#include "team_classification.h"
+
+// Scalar progress of a file-mode run, captured between two frames.
+//
+// The MOG2 model has no serialization API, so it is not stored. It only
+// depends on the frames fed to it since it was last recreated (start of the
+// video or the last shot cut), with a learning rate that is a function of the
+// frame's position in that epoch. Resuming replays that epoch through the
+// background model alone, which rebuilds it exactly.
+struct PipelineProgress {
+    std::string videoPath;
+    std::string detectorSignature;
+    bool gateEnabled;
+    int nextFrameIndex;
+    int backgroundEpochStart;
+    int framesSinceReset;
+    bool backgroundStale;
+    int skippedRangeStart;
+    int skippedFrameCount;
+    int shotCutCount;
+    long long detectionCsvBytes;
+    long long skippedCsvBytes;
+
+    PipelineProgress() : gateEnabled(true), nextFrameIndex(0), backgroundEpochStart(0), framesSinceReset(0),
+                         backgroundStale(false), skippedRangeStart(-1), skippedFrameCount(0), shotCutCount(0),
+                         detectionCsvBytes(0), skippedCsvBytes(0) {}
+};
+
+// The heatmap's first frame is stored once, next to the checkpoint, rather
+// than in every checkpoint; it must be saved before the first checkpoint
+// whose heatmap has one.
+bool saveCheckpointHeatmapFrame(const std::string &path, const Heatmap &heatmap);
+bool saveCheckpoint(const std::string &path, const PipelineProgress &progress, const FrameGate &frameGate,
+                    const TeamClassifierState &teamState, const Heatmap &heatmap);
+bool loadCheckpoint(const std::string &path, PipelineProgress &progress, FrameGate &frameGate,
+                    TeamClassifierState &teamState, Heatmap &heatmap);
+
+#endif
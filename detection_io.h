@@ -0,0 +1,359 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+// detection_io.h
+// Box type shared by the evaluation tools, and the binary columnar box file
+// (.svdb) that yolo_to_csv can write and detection_evaluator can read in place
+// of a CSV. Layout, native endian:
+//   "SVDB" magic, uint32 version
+//   blocks of: uint32 n (0 ends the file), int32 frame[n],
+//              float x1[n], float y1[n], float x2[n], float y2[n]
+// Rows are stored in file order (sorted by frame when written by yolo_to_csv).
+// Also holds the CSV row parsing and the per-frame greedy IoU matching, shared
+// by detection_evaluator and the in-process evaluation of detect.
+#ifndef DETECTION_IO_H
+#define DETECTION_IO_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Box
+{
+    double x1, y1, x2, y2;
+};
+
+static const char BOX_COLUMNS_MAGIC[4] = {'S', 'V', 'D', 'B'};
+static const uint32_t BOX_COLUMNS_VERSION = 1;
+static const size_t BOX_COLUMNS_BLOCK_ROWS = 4096;
+
+static inline bool is_box_columns_file(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[4] = {0, 0, 0, 0};
+    in.read(magic, 4);
+    return in && std::memcmp(magic, BOX_COLUMNS_MAGIC, 4) == 0;
+}
+
+class BoxColumnWriter
+{
+    std::ofstream out;
+    std::vector<int32_t> frames;
+    std::vector<float> x1, y1, x2, y2;
+
+    template <typename T>
+    void write_column(const std::vector<T> &column)
+    {
+        out.write(reinterpret_cast<const char *>(column.data()), (std::streamsize)(column.size() * sizeof(T)));
+    }
+
+    void flush_block()
+    {
+        if (frames.empty())
+            return;
+        const uint32_t n = (uint32_t)frames.size();
+        out.write(reinterpret_cast<const char *>(&n), sizeof(n));
+        write_column(frames);
+        write_column(x1);
+        write_column(y1);
+        write_column(x2);
+        write_column(y2);
+        frames.clear();
+        x1.clear();
+        y1.clear();
+        x2.clear();
+        y2.clear();
+    }
+
+public:
+    ~BoxColumnWriter() { close(); }
+
+    bool open(const std::string &path)
+    {
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        out.write(BOX_COLUMNS_MAGIC, 4);
+        out.write(reinterpret_cast<const char *>(&BOX_COLUMNS_VERSION), sizeof(BOX_COLUMNS_VERSION));
+        frames.reserve(BOX_COLUMNS_BLOCK_ROWS);
+        x1.reserve(BOX_COLUMNS_BLOCK_ROWS);
+        y1.reserve(BOX_COLUMNS_BLOCK_ROWS);
+        x2.reserve(BOX_COLUMNS_BLOCK_ROWS);
+        y2.reserve(BOX_COLUMNS_BLOCK_ROWS);
+        return (bool)out;
+    }
+
+    void add(int frame, const Box &b)
+    {
+        frames.push_back(frame);
+        x1.push_back((float)b.x1);
+        y1.push_back((float)b.y1);
+        x2.push_back((float)b.x2);
+        y2.push_back((float)b.y2);
+        if (frames.size() == BOX_COLUMNS_BLOCK_ROWS)
+            flush_block();
+    }
+
+    bool close()
+    {
+        if (!out.is_open())
+            return true;
+        flush_block();
+        const uint32_t end = 0;
+        out.write(reinterpret_cast<const char *>(&end), sizeof(end));
+        out.close();
+        return !out.fail();
+    }
+};
+
+// Reads one block at a time, so memory use does not depend on file length.
+class BoxColumnReader
+{
+    std::ifstream in;
+    std::vector<int32_t> frames;
+    std::vector<float> x1, y1, x2, y2;
+    size_t pos = 0;
+    bool done = false;
+
+    template <typename T>
+    bool read_column(std::vector<T> &column, uint32_t n)
+    {
+        column.resize(n);
+        in.read(reinterpret_cast<char *>(column.data()), (std::streamsize)(n * sizeof(T)));
+        return (bool)in;
+    }
+
+    bool read_block()
+    {
+        uint32_t n = 0;
+        in.read(reinterpret_cast<char *>(&n), sizeof(n));
+        if (!in || n == 0)
+            return false;
+        pos = 0;
+        return read_column(frames, n) && read_column(x1, n) && read_column(y1, n) &&
+               read_column(x2, n) && read_column(y2, n);
+    }
+
+public:
+    bool open(const std::string &path)
+    {
+        in.open(path, std::ios::binary);
+        char magic[4];
+        uint32_t version = 0;
+        in.read(magic, 4);
+        in.read(reinterpret_cast<char *>(&version), sizeof(version));
+        return in && std::memcmp(magic, BOX_COLUMNS_MAGIC, 4) == 0 && version == BOX_COLUMNS_VERSION;
+    }
+
+    bool next(int &frame, Box &b)
+    {
+        while (!done && pos >= frames.size())
+        {
+            if (!read_block())
+                done = true;
+        }
+        if (done)
+            return false;
+        frame = frames[pos];
+        b = Box{x1[pos], y1[pos], x2[pos], y2[pos]};
+        ++pos;
+        return true;
+    }
+};
+
+static inline void strip_cr(std::string &s)
+{
+    if (!s.empty() && s.back() == '\r')
+        s.pop_back();
+}
+static inline void strip_bom(std::string &s)
+{
+    const unsigned char bom[3] = {0xEF, 0xBB, 0xBF};
+    if (s.size() >= 3 &&
+        (unsigned char)s[0] == bom[0] &&
+        (unsigned char)s[1] == bom[1] &&
+        (unsigned char)s[2] == bom[2])
+    {
+        s.erase(0, 3);
+    }
+}
+static inline bool is_header_like(const std::vector<std::string> &t)
+{
+    if (t.size() < 5)
+        return true;
+    // crude check: any token has alpha
+    for (const auto &x : t)
+    {
+        for (char c : x)
+            if (std::isalpha((unsigned char)c))
+                return true;
+    }
+    return false;
+}
+static inline std::vector<std::string> split_csv(const std::string &line)
+{
+    // simple CSV split (no quoted fields in our use-case)
+    std::vector<std::string> out;
+    std::stringstream ss(line);
+    std::string tok;
+    while (std::getline(ss, tok, ','))
+    {
+        // trim surrounding spaces
+        size_t a = tok.find_first_not_of(" \t");
+        size_t b = tok.find_last_not_of(" \t");
+        if (a == std::string::npos)
+            out.emplace_back("");
+        else
+            out.emplace_back(tok.substr(a, b - a + 1));
+    }
+    return out;
+}
+
+static inline double iou(const Box &a, const Box &b)
+{
+    const double x1 = std::max(a.x1, b.x1);
+    const double y1 = std::max(a.y1, b.y1);
+    const double x2 = std::min(a.x2, b.x2);
+    const double y2 = std::min(a.y2, b.y2);
+    const double inter = std::max(0.0, x2 - x1) * std::max(0.0, y2 - y1);
+    const double a1 = std::max(0.0, a.x2 - a.x1) * std::max(0.0, a.y2 - a.y1);
+    const double a2 = std::max(0.0, b.x2 - b.x1) * std::max(0.0, b.y2 - b.y1);
+    const double uni = a1 + a2 - inter;
+    return uni > 0 ? inter / uni : 0.0;
+}
+
+// Streams (frame, box) rows from either a 5+ column CSV (frame,x1,y1,x2,y2,...)
+// or an .svdb file. Header-like, comment and malformed CSV rows are skipped.
+class BoxStreamReader
+{
+    std::ifstream csv;
+    BoxColumnReader columns;
+    bool binary = false;
+    bool first = true;
+    std::string line;
+
+public:
+    bool open(const std::string &path)
+    {
+        binary = is_box_columns_file(path);
+        if (binary)
+            return columns.open(path);
+        csv.open(path);
+        return csv.is_open();
+    }
+
+    bool next(int &frame, Box &b)
+    {
+        if (binary)
+            return columns.next(frame, b);
+
+        while (std::getline(csv, line))
+        {
+            strip_cr(line);
+            if (line.empty())
+                continue;
+
+            if (first)
+            {
+                strip_bom(line);
+                first = false;
+            }
+            if (line.size() && line[0] == '#')
+                continue;
+
+            auto t = split_csv(line);
+            if (t.size() < 5)
+                continue;
+            if (is_header_like(t))
+                continue; // skip header-like lines anywhere
+
+            try
+            {
+                frame = std::stoi(t[0]);
+                b = Box{std::stod(t[1]), std::stod(t[2]), std::stod(t[3]), std::stod(t[4])};
+                return true;
+            }
+            catch (...)
+            {
+                // ignore malformed rows
+                continue;
+            }
+        }
+        return false;
+    }
+};
+
+struct MatchCounts
+{
+    long tp = 0, fp = 0, fn = 0;
+    long matched = 0;
+    double iou_sum = 0.0;
+
+    void add(const MatchCounts &o)
+    {
+        tp += o.tp;
+        fp += o.fp;
+        fn += o.fn;
+        matched += o.matched;
+        iou_sum += o.iou_sum;
+    }
+    double precision() const { return (tp + fp) ? double(tp) / (tp + fp) : 0.0; }
+    double recall() const { return (tp + fn) ? double(tp) / (tp + fn) : 0.0; }
+    double f1() const
+    {
+        const double p = precision(), r = recall();
+        return (p + r) ? 2 * p * r / (p + r) : 0.0;
+    }
+    double miou() const { return matched ? iou_sum / matched : 0.0; }
+};
+
+// Greedy matching of one frame: each prediction takes its best unused ground
+// truth box, and counts as TP when that IoU reaches thr. `used` is scratch
+// space, passed in so callers can reuse it across frames.
+static inline void match_frame(const std::vector<Box> &P, const std::vector<Box> &G, double thr,
+                               std::vector<char> &used, MatchCounts &counts)
+{
+    used.assign(G.size(), 0);
+    for (const auto &pb : P)
+    {
+        double best = 0.0;
+        int best_j = -1;
+        for (int j = 0; j < (int)G.size(); ++j)
+        {
+            if (used[j])
+                continue;
+            double v = iou(pb, G[j]);
+            if (v > best)
+            {
+                best = v;
+                best_j = j;
+            }
+        }
+        if (best >= thr)
+        {
+            counts.tp++;
+            used[best_j] = 1;
+            counts.matched++;
+            counts.iou_sum += best;
+        }
+        else
+        {
+            counts.fp++;
+        }
+    }
+    for (int j = 0; j < (int)G.size(); ++j)
+        if (!used[j])
+            counts.fn++;
+}
+
+#endif
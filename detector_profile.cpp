@@ -0,0 +1,145 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "detector_profile.h"
+#include <iostream>
+
+// specializedHsvThreshold — Ignores the runtime thresholds; only selected when
+// they equal the profile's constants.
+template<class Profile>
+static void specializedHsvThreshold(const cv::Mat &hsv, cv::Mat &fieldGreen, cv::Mat &playerColor,
+                                    const DetectorParams &){
+    thresholdHsv(hsv, fieldGreen, playerColor, Profile());
+}
+
+void genericHsvThreshold(const cv::Mat &hsv, cv::Mat &fieldGreen, cv::Mat &playerColor,
+                         const DetectorParams &params){
+    thresholdHsv(hsv, fieldGreen, playerColor, params);
+}
+
+template<class Profile>
+static bool hasProfileColors(const DetectorParams &params){
+    for(int c = 0; c < 3; c++){
+        if(params.fieldLow[c] != Profile::fieldLow[c] || params.fieldHigh[c] != Profile::fieldHigh[c])
+            return false;
+    }
+    return params.shadowMaxValue == Profile::shadowMaxValue && params.blackMax == Profile::blackMax;
+}
+
+HsvThresholdKernel selectHsvThresholdKernel(const DetectorParams &params, std::string *kernelName){
+    HsvThresholdKernel kernel = genericHsvThreshold;
+    std::string name = "generic";
+    if(hasProfileColors<Broadcast1080p>(params)){
+        kernel = specializedHsvThreshold<Broadcast1080p>;
+        name = Broadcast1080p::name;
+    } else if(hasProfileColors<TacticalCam4K>(params)){
+        kernel = specializedHsvThreshold<TacticalCam4K>;
+        name = TacticalCam4K::name;
+    } else if(hasProfileColors<LowResScouting>(params)){
+        kernel = specializedHsvThreshold<LowResScouting>;
+        name = LowResScouting::name;
+    }
+    if(kernelName) *kernelName = name;
+    return kernel;
+}
+
+const DetectorParams &defaultDetectorParams(){
+    static const DetectorParams params = makeDetectorParams<Broadcast1080p>();
+    return params;
+}
+
+std::vector<std::string> detectorProfileNames(){
+    std::vector<std::string> names;
+    names.push_back(Broadcast1080p::name);
+    names.push_back(TacticalCam4K::name);
+    names.push_back(LowResScouting::name);
+    return names;
+}
+
+bool findDetectorProfile(const std::string &name, DetectorParams &params){
+    if(name == Broadcast1080p::name) params = makeDetectorParams<Broadcast1080p>();
+    else if(name == TacticalCam4K::name) params = makeDetectorParams<TacticalCam4K>();
+    else if(name == LowResScouting::name) params = makeDetectorParams<LowResScouting>();
+    else return false;
+    return true;
+}
+
+template<typename T>
+static void readIfPresent(const cv::FileNode &root, const char *key, T &value){
+    cv::FileNode node = root[key];
+    if(!node.empty()) node >> value;
+}
+
+static bool readTripleIfPresent(const cv::FileNode &root, const char *key, int value[3]){
+    cv::FileNode node = root[key];
+    if(node.empty()) return true;
+    std::vector<int> values;
+    node >> values;
+    if(values.size() != 3){
+        std::cerr << "Error: " << key << " needs three values (H, S, V)\n";
+        return false;
+    }
+    for(int c = 0; c < 3; c++) value[c] = values[c];
+    return true;
+}
+
+// loadDetectorParams — Runtime configuration for experiments, as a YAML or
+// JSON file readable by cv::FileStorage. An optional "profile" key names the
+// built-in profile to start from (the current params otherwise); any other
+// key overrides the field of the same name. Colour thresholds that no longer
+// match a profile run through the generic kernel.
+bool loadDetectorParams(const std::string &path, DetectorParams &params){
+    cv::FileStorage storage;
+    try {
+        if(!storage.open(path, cv::FileStorage::READ)) return false;
+        cv::FileNode root = storage.root();
+
+        std::string baseProfile;
+        readIfPresent(root, "profile", baseProfile);
+        if(!baseProfile.empty() && !findDetectorProfile(baseProfile, params)) return false;
+        params.name = path;
+
+        if(!readTripleIfPresent(root, "fieldLow", params.fieldLow) ||
+           !readTripleIfPresent(root, "fieldHigh", params.fieldHigh)) return false;
+        readIfPresent(root, "shadowMaxValue", params.shadowMaxValue);
+        readIfPresent(root, "blackMax", params.blackMax);
+        readIfPresent(root, "fieldKernel", params.fieldKernel);
+        readIfPresent(root, "fieldErosions", params.fieldErosions);
+        readIfPresent(root, "minFieldArea", params.minFieldArea);
+        readIfPresent(root, "playerDilationRadius", params.playerDilationRadius);
+        readIfPresent(root, "openingKernel", params.openingKernel);
+        readIfPresent(root, "minContourArea", params.minContourArea);
+        readIfPresent(root, "minBoxWidth", params.minBoxWidth);
+        readIfPresent(root, "minBoxHeight", params.minBoxHeight);
+        readIfPresent(root, "maxBoxWidth", params.maxBoxWidth);
+        readIfPresent(root, "maxBoxHeight", params.maxBoxHeight);
+        readIfPresent(root, "backgroundHistory", params.backgroundHistory);
+        readIfPresent(root, "backgroundVarThreshold", params.backgroundVarThreshold);
+        readIfPresent(root, "backgroundMixtures", params.backgroundMixtures);
+        readIfPresent(root, "backgroundScale", params.backgroundScale);
+        readIfPresent(root, "tileRows", params.tileRows);
+        readIfPresent(root, "featureRoiWidth", params.featureRoi.width);
+        readIfPresent(root, "featureRoiHeight", params.featureRoi.height);
+        readIfPresent(root, "jerseyFraction", params.jerseyFraction);
+    } catch(const cv::Exception &e){
+        std::cerr << "Error: " << path << ": " << e.what() << "\n";
+        return false;
+    }
+    return true;
+}
+
+// applyLowMemorySettings — MOG2 holds 5 float Gaussians of (weight, variance,
+// B, G, R) per pixel, 100 bytes per pixel or about 800 MiB at 4K. At half
+// resolution with 3 mixtures it needs 60 bytes per quarter of the pixels,
+// 15 bytes per frame pixel. The HSV copy of the frame shrinks to one 64-row
+// strip.
+void applyLowMemorySettings(DetectorParams &params){
+    params.backgroundMixtures = 3;
+    params.backgroundScale = 0.5;
+    params.tileRows = 64;
+}
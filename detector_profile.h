@@ -0,0 +1,225 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef DETECTOR_PROFILE_H
+#define DETECTOR_PROFILE_H
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// DetectorParams — Every threshold used by player detection and jersey feature
+// extraction. HSV values use OpenCV's 8-bit ranges (H 0..179, S and V 0..255)
+// and all colour bounds are inclusive.
+struct DetectorParams {
+    std::string name;
+
+    // Colour classes shared by the field mask, the player mask and the jersey
+    // features.
+    int fieldLow[3];          // pitch green, lower H,S,V
+    int fieldHigh[3];         // pitch green, upper H,S,V
+    int shadowMaxValue;       // V at or below this is shadow
+    int blackMax;             // H, S and V all at or below this is black
+
+    // Field mask: one dilation then fieldErosions erosions with a square kernel,
+    // keeping contours larger than minFieldArea.
+    int fieldKernel;
+    int fieldErosions;
+    double minFieldArea;
+
+    // Player mask and box filtering.
+    int playerDilationRadius;
+    int openingKernel;        // ellipse diameter for the final opening
+    double minContourArea;
+    int minBoxWidth, minBoxHeight, maxBoxWidth, maxBoxHeight;
+
+    // MOG2 background model. The model keeps backgroundMixtures Gaussians per
+    // pixel (history only sets its learning rate, no frames are stored), so
+    // its size is set by the mixture count and the resolution it runs at:
+    // backgroundScale < 1 runs it on a downscaled frame and upscales the
+    // foreground mask.
+    int backgroundHistory;
+    double backgroundVarThreshold;
+    int backgroundMixtures;
+    double backgroundScale;
+
+    // Colour classification converts the frame to HSV in strips of tileRows
+    // rows instead of all at once; 0 means whole frames. Does not affect
+    // results.
+    int tileRows;
+
+    // Jersey features: player ROIs are resized to featureRoi and the top
+    // jerseyFraction of the rows is used.
+    cv::Size featureRoi;
+    double jerseyFraction;
+
+    // Show the intermediate mask windows. Does not affect results.
+    bool debugViews;
+};
+
+// Built-in profiles. Each is a set of compile-time constants; thresholdHsv
+// instantiated on a profile type folds them into the pixel loop.
+
+// Natural grass under broadcast lighting; the thresholds the pipeline was
+// originally tuned with.
+struct BroadcastGrassColors {
+    static constexpr int fieldLow[3] = {40, 40, 40};
+    static constexpr int fieldHigh[3] = {90, 255, 255};
+    static constexpr int shadowMaxValue = 50;
+    static constexpr int blackMax = 10;
+};
+
+// Broadcast 1080p: players roughly 10-100 px wide.
+struct Broadcast1080p : BroadcastGrassColors {
+    static constexpr const char *name = "broadcast1080p";
+    static constexpr int fieldKernel = 5;
+    static constexpr int fieldErosions = 4;
+    static constexpr double minFieldArea = 1000.0;
+    static constexpr int playerDilationRadius = 5;
+    static constexpr int openingKernel = 5;
+    static constexpr double minContourArea = 30.0;
+    static constexpr int minBoxWidth = 10, minBoxHeight = 20, maxBoxWidth = 100, maxBoxHeight = 200;
+    static constexpr int backgroundHistory = 500;
+    static constexpr double backgroundVarThreshold = 16.0;
+    static constexpr int featureRoiWidth = 32, featureRoiHeight = 64;
+    static constexpr double jerseyFraction = 0.6;
+};
+
+// Fixed wide-angle tactical camera at 4K: the whole pitch is in view, so
+// players are small relative to the frame but larger in pixels than in
+// broadcast, and the sharper image needs a narrower, brighter green.
+struct TacticalCam4K {
+    static constexpr const char *name = "tactical4k";
+    static constexpr int fieldLow[3] = {38, 45, 50};
+    static constexpr int fieldHigh[3] = {88, 255, 255};
+    static constexpr int shadowMaxValue = 55;
+    static constexpr int blackMax = 12;
+    static constexpr int fieldKernel = 9;
+    static constexpr int fieldErosions = 4;
+    static constexpr double minFieldArea = 4000.0;
+    static constexpr int playerDilationRadius = 7;
+    static constexpr int openingKernel = 7;
+    static constexpr double minContourArea = 80.0;
+    static constexpr int minBoxWidth = 14, minBoxHeight = 28, maxBoxWidth = 180, maxBoxHeight = 360;
+    static constexpr int backgroundHistory = 500;
+    static constexpr double backgroundVarThreshold = 16.0;
+    static constexpr int featureRoiWidth = 32, featureRoiHeight = 64;
+    static constexpr double jerseyFraction = 0.6;
+};
+
+// Low-resolution scouting footage (360p-540p, heavily compressed): small
+// players, washed-out colours, and a wider green range to absorb blocking.
+struct LowResScouting {
+    static constexpr const char *name = "scouting";
+    static constexpr int fieldLow[3] = {35, 30, 35};
+    static constexpr int fieldHigh[3] = {95, 255, 255};
+    static constexpr int shadowMaxValue = 40;
+    static constexpr int blackMax = 10;
+    static constexpr int fieldKernel = 3;
+    static constexpr int fieldErosions = 3;
+    static constexpr double minFieldArea = 250.0;
+    static constexpr int playerDilationRadius = 2;
+    static constexpr int openingKernel = 3;
+    static constexpr double minContourArea = 8.0;
+    static constexpr int minBoxWidth = 4, minBoxHeight = 8, maxBoxWidth = 50, maxBoxHeight = 100;
+    static constexpr int backgroundHistory = 300;
+    static constexpr double backgroundVarThreshold = 16.0;
+    static constexpr int featureRoiWidth = 16, featureRoiHeight = 32;
+    static constexpr double jerseyFraction = 0.6;
+};
+
+// makeDetectorParams — Runtime copy of a compile-time profile.
+template<class Profile>
+DetectorParams makeDetectorParams(){
+    DetectorParams params;
+    params.name = Profile::name;
+    for(int c = 0; c < 3; c++){
+        params.fieldLow[c] = Profile::fieldLow[c];
+        params.fieldHigh[c] = Profile::fieldHigh[c];
+    }
+    params.shadowMaxValue = Profile::shadowMaxValue;
+    params.blackMax = Profile::blackMax;
+    params.fieldKernel = Profile::fieldKernel;
+    params.fieldErosions = Profile::fieldErosions;
+    params.minFieldArea = Profile::minFieldArea;
+    params.playerDilationRadius = Profile::playerDilationRadius;
+    params.openingKernel = Profile::openingKernel;
+    params.minContourArea = Profile::minContourArea;
+    params.minBoxWidth = Profile::minBoxWidth;
+    params.minBoxHeight = Profile::minBoxHeight;
+    params.maxBoxWidth = Profile::maxBoxWidth;
+    params.maxBoxHeight = Profile::maxBoxHeight;
+    params.backgroundHistory = Profile::backgroundHistory;
+    params.backgroundVarThreshold = Profile::backgroundVarThreshold;
+    // Memory settings are independent of the footage; see applyLowMemorySettings.
+    params.backgroundMixtures = 5;
+    params.backgroundScale = 1.0;
+    params.tileRows = 0;
+    params.featureRoi = cv::Size(Profile::featureRoiWidth, Profile::featureRoiHeight);
+    params.jerseyFraction = Profile::jerseyFraction;
+    params.debugViews = true;
+    return params;
+}
+
+// thresholdHsv — Fused colour classification of an 8-bit HSV image:
+// fieldGreen marks pitch green, playerColor marks pixels that are neither
+// green, shadow nor black. Replaces five inRange calls and three bitwise
+// passes. Thresholds is either a profile type, whose constants are folded
+// into the loop, or a DetectorParams read at run time.
+template<class Thresholds>
+void thresholdHsv(const cv::Mat &hsv, cv::Mat &fieldGreen, cv::Mat &playerColor, const Thresholds &t){
+    CV_Assert(hsv.type() == CV_8UC3);
+    fieldGreen.create(hsv.size(), CV_8UC1);
+    playerColor.create(hsv.size(), CV_8UC1);
+
+    // Range checks as one unsigned compare each: (value - low) <= (high - low).
+    const uchar hLow = (uchar)t.fieldLow[0], sLow = (uchar)t.fieldLow[1], vLow = (uchar)t.fieldLow[2];
+    const uchar hSpan = (uchar)(t.fieldHigh[0] - t.fieldLow[0]);
+    const uchar sSpan = (uchar)(t.fieldHigh[1] - t.fieldLow[1]);
+    const uchar vSpan = (uchar)(t.fieldHigh[2] - t.fieldLow[2]);
+    const uchar shadowMax = (uchar)t.shadowMaxValue, blackMax = (uchar)t.blackMax;
+
+    // Bounds are kept in locals: the compiler cannot prove the output stores
+    // leave hsv.cols unchanged, and an unknown trip count blocks vectorization.
+    const int rows = hsv.rows, cols = hsv.cols;
+    for(int y = 0; y < rows; y++){
+        // Interleaved H,S,V read in place: no plane copies, so a call
+        // allocates nothing once its outputs exist.
+        const uchar *hsvRow = hsv.ptr<uchar>(y);
+        uchar *green = fieldGreen.ptr<uchar>(y);
+        uchar *player = playerColor.ptr<uchar>(y);
+        // Branch-free body on 8-bit lanes.
+        for(int x = 0; x < cols; x++){
+            const uchar h = hsvRow[3*x], s = hsvRow[3*x + 1], v = hsvRow[3*x + 2];
+            const uchar isGreen = (uchar)((uchar)(h - hLow) <= hSpan) & (uchar)((uchar)(s - sLow) <= sSpan)
+                                & (uchar)((uchar)(v - vLow) <= vSpan);
+            const uchar isShadow = (uchar)(v <= shadowMax);
+            const uchar isBlack = (uchar)(h <= blackMax) & (uchar)(s <= blackMax) & (uchar)(v <= blackMax);
+            green[x] = (uchar)(0 - isGreen);
+            player[x] = (uchar)((isGreen | isShadow | isBlack) - 1);
+        }
+    }
+}
+
+typedef void (*HsvThresholdKernel)(const cv::Mat &hsv, cv::Mat &fieldGreen, cv::Mat &playerColor,
+                                   const DetectorParams &params);
+
+// Kernel for these parameters: the specialized instantiation when the colour
+// thresholds match a built-in profile, the generic one otherwise.
+HsvThresholdKernel selectHsvThresholdKernel(const DetectorParams &params, std::string *kernelName = 0);
+void genericHsvThreshold(const cv::Mat &hsv, cv::Mat &fieldGreen, cv::Mat &playerColor,
+                         const DetectorParams &params);
+
+const DetectorParams &defaultDetectorParams();
+std::vector<std::string> detectorProfileNames();
+bool findDetectorProfile(const std::string &name, DetectorParams &params);
+bool loadDetectorParams(const std::string &path, DetectorParams &params);
+
+// Memory-bounded variant of params for many high-resolution streams per node:
+// half-resolution MOG2 with fewer mixtures and strip-wise colour conversion.
+void applyLowMemorySettings(DetectorParams &params);
+#endif
@@ -0,0 +1,83 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "frame_gate.h"
+#include "binary_io.h"
+
+// All gate statistics are computed on a small thumbnail so the cost per frame
+// is negligible compared to detectPlayers.
+static const cv::Size THUMBNAIL_SIZE(64, 36);
+
+// Hysteresis on the green ratio: a wide pitch shot is mostly green, crowd
+// shots, close-ups and full-screen graphics are not. Two thresholds avoid
+// flickering between states on borderline frames.
+static const double PITCH_ENTER_RATIO = 0.45;
+static const double PITCH_LEAVE_RATIO = 0.35;
+
+// Bhattacharyya distance between consecutive H-S histograms above which the
+// frame is treated as a shot cut.
+static const double SHOT_CUT_DISTANCE = 0.5;
+
+FrameGate::FrameGate() : pitchVisible(true) {}
+
+// evaluate — Classify a frame as pitch / non-pitch from the fraction of green
+// pixels, and detect shot cuts by comparing its hue-saturation histogram with
+// the one of the previous frame.
+GateDecision FrameGate::evaluate(const cv::Mat &frame){
+    GateDecision decision;
+
+    cv::resize(frame, thumbnail, THUMBNAIL_SIZE, 0, 0, cv::INTER_AREA);
+    cv::cvtColor(thumbnail, thumbnailHsv, cv::COLOR_BGR2HSV);
+
+    // Same HSV green range used for the field mask in player_detection.cpp.
+    cv::inRange(thumbnailHsv, cv::Scalar(40,40,40), cv::Scalar(90,255,255), greenMask);
+    decision.greenRatio = (double)cv::countNonZero(greenMask) / THUMBNAIL_SIZE.area();
+
+    if(pitchVisible && decision.greenRatio < PITCH_LEAVE_RATIO) pitchVisible = false;
+    else if(!pitchVisible && decision.greenRatio > PITCH_ENTER_RATIO) pitchVisible = true;
+    decision.isPitch = pitchVisible;
+
+    // Hue-saturation histogram, normalized so that the distance does not
+    // depend on the thumbnail size.
+    int histSize[] = {30, 32};
+    float hueRange[] = {0, 180};
+    float saturationRange[] = {0, 256};
+    const float *ranges[] = {hueRange, saturationRange};
+    int channels[] = {0, 1};
+    cv::calcHist(&thumbnailHsv, 1, channels, cv::Mat(), currentHist, 2, histSize, ranges);
+    cv::normalize(currentHist, currentHist, 1, 0, cv::NORM_L1);
+
+    if(previousHist.empty()){
+        decision.histogramDistance = 0.0;
+        decision.isShotCut = false;
+    } else {
+        decision.histogramDistance = cv::compareHist(previousHist, currentHist, cv::HISTCMP_BHATTACHARYYA);
+        decision.isShotCut = decision.histogramDistance > SHOT_CUT_DISTANCE;
+    }
+    std::swap(previousHist, currentHist);
+
+    return decision;
+}
+
+// parameterSignature — Gate settings, part of the key of cached detections.
+std::string FrameGate::parameterSignature(){
+    return cv::format("gate-v1 thumb=%dx%d enter=%.2f leave=%.2f cut=%.2f hs=30x32",
+                      THUMBNAIL_SIZE.width, THUMBNAIL_SIZE.height,
+                      PITCH_ENTER_RATIO, PITCH_LEAVE_RATIO, SHOT_CUT_DISTANCE);
+}
+
+// saveState / loadState — Hysteresis state and the last histogram, so a
+// resumed run makes the same decisions as an uninterrupted one.
+void FrameGate::saveState(std::ostream &out) const{
+    writeBinary(out, pitchVisible);
+    writeMat(out, previousHist);
+}
+
+bool FrameGate::loadState(std::istream &in){
+    return readBinary(in, pitchVisible) && readMat(in, previousHist);
+}
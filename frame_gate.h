@@ -0,0 +1,42 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef FRAME_GATE_H
+#define FRAME_GATE_H
+
+#include <opencv2/opencv.hpp>
+#include <istream>
+#include <ostream>
+#include <string>
+
+// Result of gating one frame: whether the full pipeline should run on it and
+// whether the camera cut to a new shot since the previous frame.
+struct GateDecision {
+    bool isPitch;
+    bool isShotCut;
+    double greenRatio;
+    double histogramDistance;
+};
+
+class FrameGate {
+    cv::Mat thumbnail;
+    cv::Mat thumbnailHsv;
+    cv::Mat greenMask;
+    cv::Mat currentHist;
+    cv::Mat previousHist;
+    bool pitchVisible;
+
+public:
+    FrameGate();
+    GateDecision evaluate(const cv::Mat &frame);
+    static std::string parameterSignature();
+    void saveState(std::ostream &out) const;
+    bool loadState(std::istream &in);
+};
+
+#endif
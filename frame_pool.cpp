@@ -0,0 +1,140 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "frame_pool.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+FrameRef::FrameRef(const FrameRef &other) : pool(other.pool), slot(other.slot){
+    if(pool) pool->addReference(slot);
+}
+
+void FrameRef::reset(){
+    if(pool) pool->releaseReference(slot);
+    pool = 0;
+    slot = -1;
+}
+
+cv::Mat &FrameRef::image() const{
+    CV_Assert(pool != 0);
+    return pool->slots[slot]->image;
+}
+
+int FrameRef::useCount() const{
+    return pool ? pool->slots[slot]->references.load() : 0;
+}
+
+FramePool::FramePool(const std::string &poolName, int capacity)
+    : name(poolName), acquisitions(0), exhaustedWaits(0), failedTryAcquires(0), waitMs(0.0), inUse(0),
+      peakInUse(0), bufferAllocations(0){
+    if(capacity < 1) capacity = 1;
+    for(int i = 0; i < capacity; i++){
+        slots.emplace_back(new Slot());
+        freeSlots.push_back(capacity - 1 - i);
+    }
+}
+
+FramePool::~FramePool(){
+    // Every FrameRef must be gone by now; a leaked one would point at freed slots.
+    if(inUse != 0) std::cerr << "Frame pool " << name << " destroyed with " << inUse << " slots in use\n";
+}
+
+void FramePool::preallocate(cv::Size size, int type){
+    std::lock_guard<std::mutex> lock(mutex);
+    for(size_t i = 0; i < freeSlots.size(); i++){
+        Slot &slot = *slots[freeSlots[i]];
+        slot.image.create(size, type);
+        if(slot.image.data != slot.lastData){
+            slot.lastData = slot.image.data;
+            bufferAllocations++;
+        }
+    }
+}
+
+// Called with the mutex held and a free slot available.
+FrameRef FramePool::takeFreeSlot(){
+    int index = freeSlots.back();
+    freeSlots.pop_back();
+    slots[index]->references = 1;
+    acquisitions++;
+    inUse++;
+    if(inUse > peakInUse) peakInUse = inUse;
+    return FrameRef(this, index);
+}
+
+FrameRef FramePool::acquire(){
+    std::unique_lock<std::mutex> lock(mutex);
+    if(freeSlots.empty()){
+        exhaustedWaits++;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        slotReleased.wait(lock, [this]{ return !freeSlots.empty(); });
+        waitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return takeFreeSlot();
+}
+
+bool FramePool::tryAcquire(FrameRef &frame){
+    std::lock_guard<std::mutex> lock(mutex);
+    if(freeSlots.empty()){
+        failedTryAcquires++;
+        return false;
+    }
+    frame = takeFreeSlot();
+    return true;
+}
+
+void FramePool::addReference(int slot){
+    slots[slot]->references++;
+}
+
+void FramePool::releaseReference(int slot){
+    if(--slots[slot]->references > 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // A changed data pointer means the holder's frame did not fit the
+        // slot (first use, or a size change) and OpenCV allocated anew.
+        Slot &released = *slots[slot];
+        if(released.image.data != released.lastData){
+            released.lastData = released.image.data;
+            if(released.lastData) bufferAllocations++;
+        }
+        freeSlots.push_back(slot);
+        inUse--;
+    }
+    slotReleased.notify_one();
+}
+
+int FramePool::capacity() const{
+    return (int)slots.size();
+}
+
+long FramePool::exhaustedCount() const{
+    std::lock_guard<std::mutex> lock(mutex);
+    return exhaustedWaits;
+}
+
+size_t FramePool::bytesAllocated() const{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t bytes = 0;
+    for(size_t i = 0; i < slots.size(); i++)
+        bytes += slots[i]->image.total() * slots[i]->image.elemSize();
+    return bytes;
+}
+
+void FramePool::printStats(std::ostream &out) const{
+    size_t bytes = bytesAllocated();
+    std::lock_guard<std::mutex> lock(mutex);
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "Frame pool %s: %d slots, %.1f MiB, %ld acquisitions, peak %d in use, "
+                  "%ld buffer allocations, exhausted %ld times (%.0f ms waiting, %ld failed tries)\n",
+                  name.c_str(), (int)slots.size(), bytes / (1024.0 * 1024.0), acquisitions, peakInUse,
+                  bufferAllocations, exhaustedWaits, waitMs, failedTryAcquires);
+    out << line;
+}
@@ -0,0 +1,107 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class FramePool;
+
+// FrameRef — Counted reference to one slot of a FramePool. Copies share the
+// slot; the slot goes back to the pool when the last reference is dropped.
+//
+// A slot is written only by whoever acquired it, before handing out copies;
+// after that every holder treats the image as read-only and stages that
+// draw render into their own scratch image. Do not keep cv::Mat headers of
+// a slot past its last FrameRef: the pool decodes the next frame into the
+// same memory.
+class FrameRef {
+    FramePool *pool;
+    int slot;
+
+    friend class FramePool;
+    FrameRef(FramePool *owner, int slotIndex) : pool(owner), slot(slotIndex) {}
+
+public:
+    FrameRef() : pool(0), slot(-1) {}
+    FrameRef(const FrameRef &other);
+    FrameRef(FrameRef &&other) noexcept : pool(other.pool), slot(other.slot){
+        other.pool = 0;
+        other.slot = -1;
+    }
+    FrameRef &operator=(FrameRef other) noexcept{
+        std::swap(pool, other.pool);
+        std::swap(slot, other.slot);
+        return *this;
+    }
+    ~FrameRef(){ reset(); }
+
+    void reset();
+    bool empty() const { return pool == 0; }
+    cv::Mat &image() const;
+    int useCount() const;
+};
+
+// FramePool — Fixed number of reusable frame buffers. Memory is bounded by
+// the slot count however many stages and threads hold frames; when every
+// slot is in use, acquire() waits for one to be released and the wait is
+// recorded, so an undersized pool shows up in the statistics.
+class FramePool {
+    struct Slot {
+        cv::Mat image;
+        std::atomic<int> references;
+        const uchar *lastData;
+
+        Slot() : references(0), lastData(0) {}
+    };
+
+    std::string name;
+    std::vector<std::unique_ptr<Slot> > slots;
+    std::vector<int> freeSlots;
+    mutable std::mutex mutex;
+    std::condition_variable slotReleased;
+
+    long acquisitions;
+    long exhaustedWaits;
+    long failedTryAcquires;
+    double waitMs;
+    int inUse;
+    int peakInUse;
+    long bufferAllocations;
+
+    friend class FrameRef;
+    void addReference(int slot);
+    void releaseReference(int slot);
+    FrameRef takeFreeSlot();
+
+public:
+    FramePool(const std::string &poolName, int capacity);
+    ~FramePool();
+
+    // Allocate every slot up front when the frame size is known; otherwise
+    // slots are allocated by the first frame decoded into them.
+    void preallocate(cv::Size size, int type);
+
+    FrameRef acquire();
+    bool tryAcquire(FrameRef &frame);
+
+    int capacity() const;
+    long exhaustedCount() const;
+    size_t bytesAllocated() const;
+    void printStats(std::ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "live_evaluation.h"
+#include <iomanip>
+#include <iostream>
+
+static void printCounts(std::ostream &out, const MatchCounts &counts){
+    out << "TP=" << counts.tp << " FP=" << counts.fp << " FN=" << counts.fn
+        << std::fixed << std::setprecision(3)
+        << " Precision=" << counts.precision()
+        << " Recall=" << counts.recall()
+        << " F1=" << counts.f1()
+        << " mIoU=" << counts.miou();
+    out.unsetf(std::ios::floatfield);
+}
+
+LiveEvaluator::LiveEvaluator()
+    : iouThreshold(0.5), groundTruthOffset(0), reportEvery(0), hasPending(false), pendingFrame(0),
+      outOfOrderRows(0), framesInWindow(0), lastFrame(-1) {}
+
+bool LiveEvaluator::open(const std::string &groundTruthPath, double threshold, int offset, int reportInterval){
+    iouThreshold = threshold;
+    groundTruthOffset = offset;
+    reportEvery = reportInterval;
+    if(!groundTruth.open(groundTruthPath)) return false;
+    readNext();
+    return true;
+}
+
+// readNext — One-row lookahead into the ground truth stream.
+void LiveEvaluator::readNext(){
+    int previousFrame = pendingFrame;
+    bool hadPrevious = hasPending;
+    hasPending = groundTruth.next(pendingFrame, pendingBox);
+    if(!hasPending) return;
+    pendingFrame += groundTruthOffset;
+    if(hadPrevious && pendingFrame < previousFrame){
+        if(outOfOrderRows == 0)
+            std::cerr << "Warning: ground truth is not sorted by frame; "
+                         "out-of-order rows are counted as misses\n";
+        outOfOrderRows++;
+    }
+}
+
+// advanceTo — Ground-truth rows of earlier frames that never got predictions
+// (gated out, dropped in live mode, or simply empty) are misses.
+void LiveEvaluator::advanceTo(int frameIndex){
+    while(hasPending && pendingFrame < frameIndex){
+        windowCounts.fn++;
+        readNext();
+    }
+}
+
+// matchFrame — Collect this frame's ground truth and match it against
+// framePredictions.
+void LiveEvaluator::matchFrame(int frameIndex){
+    advanceTo(frameIndex);
+    frameTruth.clear();
+    while(hasPending && pendingFrame == frameIndex){
+        frameTruth.push_back(pendingBox);
+        readNext();
+    }
+    match_frame(framePredictions, frameTruth, iouThreshold, matchScratch, windowCounts);
+    lastFrame = frameIndex;
+}
+
+void LiveEvaluator::addFrame(int frameIndex, const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers){
+    framePredictions.clear();
+    for(size_t i = 0; i < classifiedPlayers.size(); i++){
+        const cv::Rect &box = classifiedPlayers[i].first;
+        framePredictions.push_back(Box{(double)box.x, (double)box.y,
+                                       (double)(box.x + box.width), (double)(box.y + box.height)});
+    }
+    matchFrame(frameIndex);
+
+    framesInWindow++;
+    if(reportEvery > 0 && framesInWindow >= reportEvery) report(std::cerr);
+}
+
+// catchUp — After a resume, score the predictions the interrupted run already
+// wrote (frames before endFrame), so totals cover the whole video.
+void LiveEvaluator::catchUp(const std::string &predictionsPath, int endFrame){
+    BoxStreamReader predictions;
+    if(!predictions.open(predictionsPath)) return;
+
+    int frame = -1, rowFrame;
+    Box box;
+    framePredictions.clear();
+    while(predictions.next(rowFrame, box) && rowFrame < endFrame){
+        if(rowFrame != frame && frame >= 0){
+            matchFrame(frame);
+            framePredictions.clear();
+        }
+        frame = rowFrame;
+        framePredictions.push_back(box);
+    }
+    if(frame >= 0) matchFrame(frame);
+    framePredictions.clear();
+    advanceTo(endFrame);
+    totalCounts.add(windowCounts);
+    windowCounts = MatchCounts();
+}
+
+// report — Rolling metrics: the last window and the running total, so a bad
+// parameter set shows up long before the end of the video.
+void LiveEvaluator::report(std::ostream &out){
+    totalCounts.add(windowCounts);
+    out << "Eval @" << lastFrame << " last " << framesInWindow << " frames: ";
+    printCounts(out, windowCounts);
+    out << "\n  running total: ";
+    printCounts(out, totalCounts);
+    out << "\n";
+    windowCounts = MatchCounts();
+    framesInWindow = 0;
+}
+
+// finish — Remaining ground truth (frames after the last processed one) are
+// misses, as in detection_evaluator. Prints the final totals.
+void LiveEvaluator::finish(std::ostream &out){
+    while(hasPending){
+        windowCounts.fn++;
+        readNext();
+    }
+    totalCounts.add(windowCounts);
+    windowCounts = MatchCounts();
+    framesInWindow = 0;
+
+    out << "Evaluation: ";
+    printCounts(out, totalCounts);
+    out << "\n";
+}
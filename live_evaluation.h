@@ -0,0 +1,57 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef LIVE_EVALUATION_H
+#define LIVE_EVALUATION_H
+
+#include <opencv2/opencv.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "detection_io.h"
+
+// LiveEvaluator — Scores detections against a ground-truth box file while
+// detect runs. The ground truth is streamed in a merge-join with the frames
+// as they are processed, so memory stays constant however long the match is.
+// Counting follows detection_evaluator exactly: same greedy per-frame
+// matching, and ground-truth boxes of frames without predictions are misses.
+// The ground truth must be sorted by frame, as written by yolo_to_csv.
+class LiveEvaluator {
+    BoxStreamReader groundTruth;
+    double iouThreshold;
+    int groundTruthOffset;
+    int reportEvery;
+
+    bool hasPending;
+    int pendingFrame;
+    Box pendingBox;
+    long outOfOrderRows;
+
+    std::vector<Box> frameTruth;
+    std::vector<Box> framePredictions;
+    std::vector<char> matchScratch;
+
+    MatchCounts totalCounts;
+    MatchCounts windowCounts;
+    int framesInWindow;
+    int lastFrame;
+
+    void readNext();
+    void advanceTo(int frameIndex);
+    void matchFrame(int frameIndex);
+    void report(std::ostream &out);
+
+public:
+    LiveEvaluator();
+    bool open(const std::string &groundTruthPath, double threshold, int offset, int reportInterval);
+    void addFrame(int frameIndex, const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers);
+    void catchUp(const std::string &predictionsPath, int endFrame);
+    void finish(std::ostream &out);
+};
+
+#endif
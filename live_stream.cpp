@@ -0,0 +1,191 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "live_stream.h"
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+static const int LATENCY_BUCKETS = 16;
+
+LatencyHistogram::LatencyHistogram()
+    : bucketCounts(LATENCY_BUCKETS, 0), sampleCount(0), sumMs(0.0), maxMs(0.0) {}
+
+void LatencyHistogram::record(double latencyMs){
+    int bucket = 0;
+    double upperBound = 1.0;
+    while(bucket < LATENCY_BUCKETS - 1 && latencyMs >= upperBound){
+        upperBound *= 2.0;
+        bucket++;
+    }
+    bucketCounts[bucket]++;
+    sampleCount++;
+    sumMs += latencyMs;
+    if(latencyMs > maxMs) maxMs = latencyMs;
+}
+
+// percentile — Upper bound of the bucket containing the requested fraction
+// of samples; conservative by at most a factor of two.
+double LatencyHistogram::percentile(double fraction) const{
+    if(sampleCount == 0) return 0.0;
+    long target = (long)(fraction * sampleCount);
+    long seen = 0;
+    double upperBound = 1.0;
+    for(int i = 0; i < LATENCY_BUCKETS; i++){
+        seen += bucketCounts[i];
+        if(seen > target) return std::min(upperBound, maxMs);
+        upperBound *= 2.0;
+    }
+    return maxMs;
+}
+
+void LatencyHistogram::print(std::ostream &out) const{
+    out << std::fixed << std::setprecision(1)
+        << "Latency: n=" << sampleCount
+        << " mean=" << (sampleCount ? sumMs / sampleCount : 0.0) << "ms"
+        << " p50<=" << percentile(0.50) << "ms"
+        << " p95<=" << percentile(0.95) << "ms"
+        << " p99<=" << percentile(0.99) << "ms"
+        << " max=" << maxMs << "ms\n";
+
+    double lowerBound = 0.0, upperBound = 1.0;
+    for(int i = 0; i < LATENCY_BUCKETS; i++){
+        if(bucketCounts[i] > 0){
+            out << "  [" << std::setw(7) << lowerBound << ", ";
+            if(i == LATENCY_BUCKETS - 1) out << "    inf) ";
+            else out << std::setw(7) << upperBound << ") ";
+            out << bucketCounts[i] << "\n";
+        }
+        lowerBound = upperBound;
+        upperBound *= 2.0;
+    }
+    out.unsetf(std::ios::floatfield);
+}
+
+LiveFrameSource::LiveFrameSource(FramePool &pool, double latencyBudget, size_t capacity)
+    : framePool(pool), rawMode(false), latencyBudgetMs(latencyBudget), bufferCapacity(capacity < 1 ? 1 : capacity),
+      endOfStream(false), stopping(false), nextSequence(0), overflowDrops(0), staleDrops(0) {}
+
+LiveFrameSource::~LiveFrameSource(){
+    stop();
+}
+
+// open — Parse the source description and start the capture thread.
+bool LiveFrameSource::open(const std::string &source){
+    if(source.compare(0, 4, "raw:") == 0){
+        int width = 0, height = 0;
+        size_t pathStart = source.find(':', 4);
+        if(pathStart == std::string::npos ||
+           std::sscanf(source.c_str() + 4, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0){
+            std::cerr << "Live: expected raw:<width>x<height>:<path>, got " << source << "\n";
+            return false;
+        }
+        rawStream.open(source.substr(pathStart + 1).c_str(), std::ios::binary);
+        if(!rawStream.is_open()) return false;
+        rawSize = cv::Size(width, height);
+        rawMode = true;
+    } else if(!capture.open(source)){
+        return false;
+    }
+
+    captureThread = std::thread(&LiveFrameSource::run, this);
+    return true;
+}
+
+bool LiveFrameSource::readFrame(cv::Mat &image){
+    if(!rawMode) return capture.read(image);
+    image.create(rawSize, CV_8UC3);
+    rawStream.read((char*)image.data, (std::streamsize)image.total() * 3);
+    return rawStream.gcount() == (std::streamsize)image.total() * 3;
+}
+
+// run — Capture thread. Each frame is decoded into its own pool slot, so
+// frames already handed to the analysis loop are never overwritten. When the
+// buffer is full, or the pool has no free slot, the oldest buffered frame is
+// discarded: a live pipeline prefers the newest picture.
+void LiveFrameSource::run(){
+    for(;;){
+        LiveFrame frame;
+        if(!framePool.tryAcquire(frame.image)){
+            {
+                std::lock_guard<std::mutex> lock(bufferMutex);
+                if(!buffered.empty()){
+                    buffered.pop_front();
+                    overflowDrops++;
+                }
+            }
+            frame.image = framePool.acquire();
+        }
+        bool ok = readFrame(frame.image.image());
+        frame.captured = LiveClock::now();
+
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if(!ok || stopping){
+            endOfStream = true;
+            frameAvailable.notify_one();
+            return;
+        }
+        frame.sequence = nextSequence++;
+        if(buffered.size() >= bufferCapacity){
+            buffered.pop_front();
+            overflowDrops++;
+        }
+        buffered.push_back(std::move(frame));
+        frameAvailable.notify_one();
+    }
+}
+
+// next — Block until a frame is available. Frames already older than the
+// latency budget are dropped, except the newest one, so the loop always makes
+// progress. Returns false at end of stream.
+bool LiveFrameSource::next(LiveFrame &frame){
+    std::unique_lock<std::mutex> lock(bufferMutex);
+    frameAvailable.wait(lock, [this]{ return endOfStream || !buffered.empty(); });
+    if(buffered.empty()) return false;
+
+    LiveClock::time_point now = LiveClock::now();
+    while(buffered.size() > 1){
+        double ageMs = std::chrono::duration<double, std::milli>(now - buffered.front().captured).count();
+        if(ageMs <= latencyBudgetMs) break;
+        buffered.pop_front();
+        staleDrops++;
+    }
+    frame = std::move(buffered.front());
+    buffered.pop_front();
+    return true;
+}
+
+// stop — Ask the capture thread to finish. A thread blocked on a raw FIFO
+// returns after the next frame or when the writer closes the pipe.
+void LiveFrameSource::stop(){
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        stopping = true;
+    }
+    if(captureThread.joinable()) captureThread.join();
+}
+
+long LiveFrameSource::droppedFrames() const{
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    return overflowDrops + staleDrops;
+}
+
+// printDropStats — Safe while the capture thread runs: the counters are read
+// under the buffer lock and printed after releasing it.
+void LiveFrameSource::printDropStats(std::ostream &out) const{
+    int captured;
+    long overflow, stale;
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        captured = nextSequence;
+        overflow = overflowDrops;
+        stale = staleDrops;
+    }
+    out << "Live: captured " << captured << " frames, dropped "
+        << overflow << " on buffer overflow and " << stale << " over the latency budget\n";
+}
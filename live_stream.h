@@ -0,0 +1,89 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef LIVE_STREAM_H
+#define LIVE_STREAM_H
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "frame_pool.h"
+
+typedef std::chrono::steady_clock LiveClock;
+
+struct LiveFrame {
+    FrameRef image;
+    int sequence;                  // index of the frame in the stream, gaps mark drops
+    LiveClock::time_point captured;
+};
+
+// LatencyHistogram — Capture-to-output latency in power-of-two millisecond
+// buckets (<1, <2, <4, ... ms), enough resolution for percentiles in reports.
+class LatencyHistogram {
+    std::vector<long> bucketCounts;
+    long sampleCount;
+    double sumMs;
+    double maxMs;
+
+public:
+    LatencyHistogram();
+    void record(double latencyMs);
+    double percentile(double fraction) const;
+    void print(std::ostream &out) const;
+};
+
+// LiveFrameSource — Reads a live source on a capture thread and hands the
+// analysis loop the freshest frames. Sources are either anything
+// cv::VideoCapture can open (pipes, device, network URL), or a raw BGR24 FIFO
+// written as "raw:<width>x<height>:<path>", e.g. by
+//   ffmpeg -i <input> -f rawvideo -pix_fmt bgr24 <path>
+// Frames that would exceed the latency budget are dropped instead of queued,
+// so the backlog never grows beyond a few frames. Frames are decoded into
+// slots of the caller's FramePool, which needs room for the buffered frames
+// plus the one being captured.
+class LiveFrameSource {
+    FramePool &framePool;
+    cv::VideoCapture capture;
+    std::ifstream rawStream;
+    cv::Size rawSize;
+    bool rawMode;
+
+    double latencyBudgetMs;
+    size_t bufferCapacity;
+    std::deque<LiveFrame> buffered;
+    mutable std::mutex bufferMutex;   // also guards the sequence and drop counters
+    std::condition_variable frameAvailable;
+    bool endOfStream;
+    bool stopping;
+    std::thread captureThread;
+
+    int nextSequence;
+    long overflowDrops;
+    long staleDrops;
+
+    bool readFrame(cv::Mat &image);
+    void run();
+
+public:
+    LiveFrameSource(FramePool &pool, double latencyBudget, size_t capacity = 4);
+    ~LiveFrameSource();
+    bool open(const std::string &source);
+    bool next(LiveFrame &frame);
+    void stop();
+    long droppedFrames() const;
+    void printDropStats(std::ostream &out) const;
+};
+
+#endif
@@ -7,56 +7,504 @@
          No external source code beyond standard libraries and OpenCV.
 ********************************************************************************/
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <vector>
 #include <iostream>
+#include <memory>
 #include "player_detection.h"
 #include "team_classification.h"
 #include "player_heatmap.h"
+#include "frame_gate.h"
+#include "video_export.h"
+#include "live_stream.h"
+#include "checkpoint.h"
+#include "live_evaluation.h"
+#include "stage_cache.h"
+#include "frame_pool.h"
+#include "memory_report.h"
+
+// Frames between samples of the per-component memory footprint.
+static const int MEMORY_SAMPLE_EVERY = 100;
+
+// seekToFrame — Position a freshly opened capture so the next read returns
+// targetFrame. The container seek lands on the frame before the target and is
+// checked against the timestamp of that decoded frame: CAP_PROP_POS_FRAMES
+// only echoes OpenCV's own counter, so a seek that stopped at the wrong
+// keyframe would pass a check against it. On any mismatch the capture is
+// rewound and frames are skipped with grab(), which only demuxes and decodes
+// without converting to BGR.
+static bool seekToFrame(cv::VideoCapture &capture, const std::string &videoPath, int targetFrame){
+    if(targetFrame <= 0) return true;
+    double fps = capture.get(cv::CAP_PROP_FPS);
+    int probeFrame = targetFrame - 1;
+    if(fps > 0 && capture.set(cv::CAP_PROP_POS_FRAMES, probeFrame) && capture.grab()){
+        double expectedMs = probeFrame * 1000.0 / fps;
+        if(std::abs(capture.get(cv::CAP_PROP_POS_MSEC) - expectedMs) < 500.0 / fps) return true;
+    }
+
+    std::cerr << "Warning: inexact seek, skipping " << targetFrame << " frames instead\n";
+    capture.release();
+    if(!capture.open(videoPath)) return false;
+    for(int i = 0; i < targetFrame; i++){
+        if(!capture.grab()) return false;
+    }
+    return true;
+}
+
+// recordMemoryUsage — Footprint of the single-stream pipeline by component.
+// Detection is skipped entirely on a complete cache hit.
+static void recordMemoryUsage(MemoryReport &report, const FramePool &framePool, const DetectorParams &params,
+                              cv::Size frameSize, bool detectionRuns, const Heatmap &heatmap,
+                              const cv::Mat &displayFrame){
+    report.record("frame pool", framePool.bytesAllocated());
+    report.recordEstimate("background model", detectionRuns ? backgroundModelBytes(params, frameSize) : 0);
+    report.recordEstimate("detection scratch", detectionRuns ? detectionScratchBytes(params, frameSize) : 0);
+    report.record("heatmap", heatmap.memoryBytes());
+    report.record("display frame", displayFrame.total() * displayFrame.elemSize());
+}
 
 int main(int argc, char **argv){
-    if(argc < 2){
-        std::cerr << "Usage: " << argv[0] << " <video_file>\n";
+    std::string videoPath;
+    bool gateEnabled = true;
+    ExportSettings exportSettings;
+    std::string liveSourcePath;
+    std::string liveOutputPath = "-";
+    double latencyBudgetMs = 200.0;
+    std::string checkpointPath;
+    int checkpointEvery = 1000;
+    bool resume = false;
+    std::string groundTruthPath;
+    double evalIouThreshold = 0.5;
+    int groundTruthOffset = 0;
+    int evalEvery = 500;
+    std::string cacheDir;
+    std::string profileName = Broadcast1080p::name;
+    std::string detectorParamsPath;
+    bool lowMemory = false;
+    int maxReplayFrames = 0;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--no-gate") gateEnabled = false;
+        else if(arg == "--export" && hasValue) exportSettings.path = argv[++i];
+        else if(arg == "--export-every" && hasValue) exportSettings.everyNthFrame = std::atoi(argv[++i]);
+        else if(arg == "--export-scale" && hasValue) exportSettings.scale = std::atof(argv[++i]);
+        else if(arg == "--export-heatmap") exportSettings.heatmapOverlay = true;
+        else if(arg == "--live" && hasValue) liveSourcePath = argv[++i];
+        else if(arg == "--live-out" && hasValue) liveOutputPath = argv[++i];
+        else if(arg == "--latency-budget" && hasValue) latencyBudgetMs = std::atof(argv[++i]);
+        else if(arg == "--checkpoint" && hasValue) checkpointPath = argv[++i];
+        else if(arg == "--checkpoint-every" && hasValue) checkpointEvery = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--resume") resume = true;
+        else if(arg == "--max-replay" && hasValue) maxReplayFrames = std::max(0, std::atoi(argv[++i]));
+        else if(arg == "--gt" && hasValue) groundTruthPath = argv[++i];
+        else if(arg == "--gt-iou" && hasValue) evalIouThreshold = std::atof(argv[++i]);
+        else if(arg == "--gt-offset" && hasValue) groundTruthOffset = std::atoi(argv[++i]);
+        else if(arg == "--eval-every" && hasValue) evalEvery = std::atoi(argv[++i]);
+        else if(arg == "--cache" && hasValue) cacheDir = argv[++i];
+        else if(arg == "--profile" && hasValue) profileName = argv[++i];
+        else if(arg == "--detector-params" && hasValue) detectorParamsPath = argv[++i];
+        else if(arg == "--low-memory") lowMemory = true;
+        else if(videoPath.empty() && arg.compare(0, 2, "--") != 0) videoPath = arg;
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            videoPath.clear();
+            break;
+        }
+    }
+    if(videoPath.empty() == liveSourcePath.empty()){
+        std::cerr << "Usage: " << argv[0] << " <video_file> [--no-gate]\n"
+                  << "       [--export <out.mp4|out.avi>] [--export-every <k>] [--export-scale <s>] [--export-heatmap]\n"
+                  << "       [--checkpoint <file>] [--checkpoint-every <frames>] [--resume]\n"
+                  << "       [--max-replay <frames>]\n"
+                  << "       [--gt <yolo.csv|yolo.svdb>] [--gt-iou <thr>] [--gt-offset <frames>] [--eval-every <frames>]\n"
+                  << "       [--cache <dir>] [--profile <name>] [--detector-params <file.yml>] [--low-memory]\n"
+                  << "   or: " << argv[0] << " --live <source|raw:WxH:fifo> [--latency-budget <ms>] [--live-out <file|->]\n";
         return -1;
     }
+    if(!checkpointPath.empty() && !liveSourcePath.empty()){
+        std::cerr << "Error: checkpoints are only supported for video files\n";
+        return -1;
+    }
+    if(resume && checkpointPath.empty()){
+        std::cerr << "Error: --resume needs --checkpoint <file>\n";
+        return -1;
+    }
+    if(!cacheDir.empty() && (!liveSourcePath.empty() || !checkpointPath.empty())){
+        std::cerr << "Error: --cache cannot be combined with --live or --checkpoint\n";
+        return -1;
+    }
+
+    // Live mode may stream its JSON lines to stdout, so every human-readable
+    // report goes to stderr there.
+    std::ostream &report = liveSourcePath.empty() ? std::cout : std::cerr;
 
-    cv::VideoCapture videoCapture(argv[1]);
-    if(!videoCapture.isOpened()){
-        std::cerr << "Error: could not open " << argv[1] << "\n";
+    // Detection thresholds: a built-in profile, optionally overridden from a
+    // parameter file for experiments.
+    DetectorParams detectorParams;
+    if(!findDetectorProfile(profileName, detectorParams)){
+        std::vector<std::string> names = detectorProfileNames();
+        std::cerr << "Error: unknown profile " << profileName << " (available:";
+        for(size_t i = 0; i < names.size(); i++) std::cerr << " " << names[i];
+        std::cerr << ")\n";
         return -1;
     }
+    if(!detectorParamsPath.empty() && !loadDetectorParams(detectorParamsPath, detectorParams)){
+        std::cerr << "Error: could not read detector parameters " << detectorParamsPath << "\n";
+        return -1;
+    }
+    // Low-memory mode bounds the per-stream footprint for many 4K streams per
+    // node: smaller background model, strip-wise colour conversion, a
+    // quarter-resolution heatmap and a short export queue.
+    if(lowMemory){
+        applyLowMemorySettings(detectorParams);
+        exportSettings.queueCapacity = 2;
+    }
+    // Live mode runs headless: no windows or debug views eat into the latency
+    // budget, and an ingest host needs no display.
+    bool showWindows = liveSourcePath.empty();
+    if(!showWindows) detectorParams.debugViews = false;
+    std::string thresholdKernelName;
+    selectHsvThresholdKernel(detectorParams, &thresholdKernelName);
+    report << "Detector profile: " << detectorParams.name << " (" << thresholdKernelName
+           << " threshold kernel" << (lowMemory ? ", low-memory" : "") << ")\n";
 
-    std::ofstream detectionCsv("ours.csv");
-    detectionCsv << "frame,x1,y1,x2,y2,team\n";
+    // Every decoded frame lives in a slot of this pool and is shared by
+    // reference with the exporter and the live buffer, so memory stays at a
+    // fixed number of frames. Sized for the analysis loop plus everything the
+    // exporter and the capture thread may hold at once.
+    const size_t LIVE_BUFFER_FRAMES = 4;
+    int framePoolSlots = 2;
+    if(!exportSettings.path.empty()) framePoolSlots += std::max(exportSettings.queueCapacity, 1) + 1;
+    if(!liveSourcePath.empty()) framePoolSlots += (int)LIVE_BUFFER_FRAMES + 1;
+    FramePool framePool("frames", framePoolSlots);
 
-    // MOG2 background subtraction — models each pixel as a Mixture of Gaussians
-    // to separate moving foreground (players) from static background (field).
-    // Parameters: history=500 frames, varThreshold=16, detectShadows=false.
-    cv::Ptr<cv::BackgroundSubtractor> bgSubtractor = cv::createBackgroundSubtractorMOG2(500, 16, false);
+    // Live mode reads on a capture thread and drops frames to stay within the
+    // latency budget; file mode processes every frame in order.
+    cv::VideoCapture videoCapture;
+    std::unique_ptr<LiveFrameSource> liveSource;
+    double fps = 0.0;
+    if(!liveSourcePath.empty()){
+        liveSource.reset(new LiveFrameSource(framePool, latencyBudgetMs, LIVE_BUFFER_FRAMES));
+        if(!liveSource->open(liveSourcePath)){
+            std::cerr << "Error: could not open live source " << liveSourcePath << "\n";
+            return -1;
+        }
+    } else {
+        if(!videoCapture.open(videoPath)){
+            std::cerr << "Error: could not open " << videoPath << "\n";
+            return -1;
+        }
+        fps = videoCapture.get(cv::CAP_PROP_FPS);
+        cv::Size frameSize((int)videoCapture.get(cv::CAP_PROP_FRAME_WIDTH),
+                           (int)videoCapture.get(cv::CAP_PROP_FRAME_HEIGHT));
+        if(frameSize.area() > 0) framePool.preallocate(frameSize, CV_8UC3);
+    }
 
-    double fps = videoCapture.get(cv::CAP_PROP_FPS);
-    int frameDelay = fps > 0 ? (int)(1000.0 / fps) : 30;
+    // One flushed line per frame in live mode, so consumers see results as
+    // soon as each frame is done.
+    std::ofstream liveOutputFile;
+    if(liveSource && liveOutputPath != "-") liveOutputFile.open(liveOutputPath);
+    std::ostream &liveOutput = liveOutputFile.is_open() ? liveOutputFile : std::cout;
+    LatencyHistogram latencyHistogram;
+    LiveClock::time_point lastLatencyReport = LiveClock::now();
+
+    cv::Ptr<cv::BackgroundSubtractor> bgSubtractor = createBackgroundModel(detectorParams);
 
-    cv::Mat frame;
     int frameIndex = 0;
-    Heatmap heatmap;
+    Heatmap heatmap(lowMemory ? LOW_MEMORY_HEATMAP_SCALE : 1.0);
+    TeamClassifierState teamState;
+
+    FrameGate frameGate;
+    int skippedRangeStart = -1;
+    int skippedFrameCount = 0;
+    int shotCutCount = 0;
+    int framesSinceReset = 0;
+    int backgroundEpochStart = 0;
+    bool backgroundStale = false;
+
+    PipelineProgress progress;
+    if(resume){
+        if(!loadCheckpoint(checkpointPath, progress, frameGate, teamState, heatmap)){
+            std::cerr << "Error: could not read checkpoint " << checkpointPath << "\n";
+            return -1;
+        }
+        if(progress.videoPath != videoPath || progress.gateEnabled != gateEnabled){
+            std::cerr << "Error: checkpoint was written for " << progress.videoPath
+                      << (progress.gateEnabled ? "" : " --no-gate") << "\n";
+            return -1;
+        }
+        if(progress.detectorSignature != detectionStageSignature(detectorParams)){
+            std::cerr << "Error: checkpoint was written with different detector parameters:\n  "
+                      << progress.detectorSignature << "\n";
+            return -1;
+        }
+        frameIndex = progress.nextFrameIndex;
+        skippedRangeStart = progress.skippedRangeStart;
+        skippedFrameCount = progress.skippedFrameCount;
+        shotCutCount = progress.shotCutCount;
+        framesSinceReset = progress.framesSinceReset;
+        backgroundEpochStart = progress.backgroundEpochStart;
+        backgroundStale = progress.backgroundStale;
 
-    cv::namedWindow("Football Player Detection", cv::WINDOW_NORMAL);
-    cv::namedWindow("Green Field Mask", cv::WINDOW_NORMAL);
-    cv::namedWindow("Players", cv::WINDOW_NORMAL);
-    cv::resizeWindow("Football Player Detection", 1280, 720);
-    cv::resizeWindow("Green Field Mask", 1280, 720);
-    cv::resizeWindow("Players", 1280, 720);
+        // Drop whatever the interrupted run wrote after the checkpoint.
+        std::error_code resizeError;
+        std::filesystem::resize_file("ours.csv", progress.detectionCsvBytes, resizeError);
+        if(!resizeError) std::filesystem::resize_file("skipped_frames.csv", progress.skippedCsvBytes, resizeError);
+        if(resizeError){
+            std::cerr << "Error: could not rewind outputs: " << resizeError.message() << "\n";
+            return -1;
+        }
+
+        // Rebuild the background model from the start of its epoch. A stale
+        // model is about to be replaced anyway, so it needs no replay. The
+        // frames before the replay are seeked over, not decoded.
+        int replayStart = backgroundStale ? frameIndex : backgroundEpochStart;
+
+        // An epoch can span the whole video (--no-gate, or one long shot).
+        // By default all of it is replayed, so the model is rebuilt exactly.
+        // --max-replay trades that for a faster resume: only the most recent
+        // frames are replayed, into a model re-warmed with the reset
+        // schedule, which matches the uninterrupted run closely but not bit
+        // for bit.
+        bool replayCapped = maxReplayFrames > 0 && frameIndex - replayStart > maxReplayFrames;
+        if(replayCapped){
+            std::cerr << "Warning: replaying only the last " << maxReplayFrames << " of " << (frameIndex - replayStart)
+                      << " frames into the background model; detections after the resume point may differ"
+                      << " slightly from an uninterrupted run\n";
+            replayStart = frameIndex - maxReplayFrames;
+        }
+
+        if(!seekToFrame(videoCapture, videoPath, replayStart)){
+            std::cerr << "Error: could not seek to frame " << replayStart << " while resuming\n";
+            return -1;
+        }
+        cv::Mat replayFrame, replayMask;
+        for(int i = replayStart; i < frameIndex; i++){
+            if(!videoCapture.read(replayFrame)){
+                std::cerr << "Error: video ended at frame " << i << " while resuming\n";
+                return -1;
+            }
+            double learningRate = backgroundLearningRate(i - replayStart, gateEnabled || replayCapped);
+            updateBackgroundModel(replayFrame, bgSubtractor, learningRate, replayMask, detectorParams);
+        }
+        report << "Resumed at frame " << frameIndex << " (replayed "
+               << (frameIndex - replayStart) << " frames into the background model)\n";
+    }
 
-    // Team A = red, Team B = blue, Unknown = green (BGR format).
-    std::vector<cv::Scalar> teamDrawColors;
-    teamDrawColors.push_back(cv::Scalar(0, 0, 255));
-    teamDrawColors.push_back(cv::Scalar(255, 0, 0));
-    teamDrawColors.push_back(cv::Scalar(0, 255, 0));
+    // In-process evaluation against ground truth, streamed alongside the video.
+    std::unique_ptr<LiveEvaluator> liveEvaluator;
+    if(!groundTruthPath.empty()){
+        liveEvaluator.reset(new LiveEvaluator());
+        if(!liveEvaluator->open(groundTruthPath, evalIouThreshold, groundTruthOffset, evalEvery)){
+            std::cerr << "Error: could not open ground truth " << groundTruthPath << "\n";
+            return -1;
+        }
+        if(resume) liveEvaluator->catchUp("ours.csv", frameIndex);
+    }
 
-    while(videoCapture.read(frame)){
-        std::vector<cv::Rect> playerBoxes = detectPlayers(frame, bgSubtractor);
-        std::vector<std::pair<cv::Rect,int> > classifiedPlayers = classifyPlayers(frame, playerBoxes);
+    std::ofstream detectionCsv("ours.csv", resume ? std::ios::app : std::ios::trunc);
+    if(!resume) detectionCsv << "frame,x1,y1,x2,y2,team\n";
+
+    // Frame ranges (inclusive) that the gate kept out of the pipeline.
+    std::ofstream skippedCsv("skipped_frames.csv", resume ? std::ios::app : std::ios::trunc);
+    if(!resume) skippedCsv << "first_frame,last_frame\n";
+    int lastCheckpointFrame = frameIndex;
+    bool heatmapFrameSaved = resume && heatmap.hasFirstFrame();
+
+    // Stage-output caches, keyed by video fingerprint and stage parameters.
+    // A run whose detection settings are unchanged skips the gate, MOG2 and
+    // detectPlayers entirely; unchanged feature settings also skip jersey
+    // feature extraction, leaving only classification and the outputs.
+    bool cacheEnabled = !cacheDir.empty();
+    StageCache detectionCache, featureCache;
+    if(cacheEnabled){
+        std::string fingerprint = fingerprintVideo(videoPath);
+        std::string detectionSignature = detectionStageSignature(detectorParams) + " | "
+            + (gateEnabled ? FrameGate::parameterSignature() + cv::format(" | warmup=%d,1/(n+1)", BACKGROUND_WARMUP_FRAMES)
+                           : cv::format("nogate | lr=%g", BACKGROUND_LEARNING_RATE));
+        detectionCache.open(cacheDir, fingerprint, "detections", detectionSignature, sizeof(cv::Rect));
+        featureCache.open(cacheDir, fingerprint, "features",
+                          detectionSignature + " | " + featureStageSignature(detectorParams), sizeof(cv::Vec3f));
+        if((!detectionCache.completeHit() && !detectionCache.startWriting()) ||
+           (!featureCache.completeHit() && !featureCache.startWriting()))
+            std::cerr << "Warning: could not write to cache directory " << cacheDir << "\n";
+    }
+    bool reachedEnd = false;
+
+    int frameDelay = fps > 0 ? (int)(1000.0 / fps) : 30;
+
+    // Annotated video export runs on its own thread; see video_export.h.
+    // After a resume it covers the frames from the resume point onwards.
+    std::unique_ptr<VideoExporter> exporter;
+    if(!exportSettings.path.empty()){
+        exportSettings.fps = fps > 0 ? fps : 25.0;
+        exporter.reset(new VideoExporter(exportSettings));
+    }
+
+    if(showWindows){
+        cv::namedWindow("Football Player Detection", cv::WINDOW_NORMAL);
+        cv::namedWindow("Green Field Mask", cv::WINDOW_NORMAL);
+        cv::namedWindow("Players", cv::WINDOW_NORMAL);
+        cv::resizeWindow("Football Player Detection", 1280, 720);
+        cv::resizeWindow("Green Field Mask", 1280, 720);
+        cv::resizeWindow("Players", 1280, 720);
+    }
+
+    std::vector<int> trackIds;
+    LiveFrame liveFrame;
+    cv::Mat displayFrame;
+    MemoryReport memoryReport;
+    cv::Size frameSize;
+
+    for(;;){
+        // Checkpoints are taken between frames, once everything for the
+        // previous frame has been written.
+        if(!checkpointPath.empty() && frameIndex > lastCheckpointFrame && frameIndex % checkpointEvery == 0){
+            detectionCsv.flush();
+            skippedCsv.flush();
+            progress.videoPath = videoPath;
+            progress.detectorSignature = detectionStageSignature(detectorParams);
+            progress.gateEnabled = gateEnabled;
+            progress.nextFrameIndex = frameIndex;
+            progress.backgroundEpochStart = backgroundEpochStart;
+            progress.framesSinceReset = framesSinceReset;
+            progress.backgroundStale = backgroundStale;
+            progress.skippedRangeStart = skippedRangeStart;
+            progress.skippedFrameCount = skippedFrameCount;
+            progress.shotCutCount = shotCutCount;
+            progress.detectionCsvBytes = (long long)std::filesystem::file_size("ours.csv");
+            progress.skippedCsvBytes = (long long)std::filesystem::file_size("skipped_frames.csv");
+            if(!heatmapFrameSaved && heatmap.hasFirstFrame())
+                heatmapFrameSaved = saveCheckpointHeatmapFrame(checkpointPath, heatmap);
+            if(heatmap.hasFirstFrame() != heatmapFrameSaved ||
+               !saveCheckpoint(checkpointPath, progress, frameGate, teamState, heatmap))
+                std::cerr << "Warning: could not write checkpoint " << checkpointPath << "\n";
+            lastCheckpointFrame = frameIndex;
+        }
+
+        // The frame is decoded once into a pool slot and only read from here
+        // on; the slot returns to the pool when the last holder lets go.
+        FrameRef currentFrame;
+        if(liveSource){
+            if(!liveSource->next(liveFrame)){
+                reachedEnd = true;
+                break;
+            }
+            currentFrame = std::move(liveFrame.image);
+            frameIndex = liveFrame.sequence;
+        } else {
+            currentFrame = framePool.acquire();
+            if(!videoCapture.read(currentFrame.image())){
+                reachedEnd = true;
+                break;
+            }
+        }
+        const cv::Mat &frame = currentFrame.image();
+        frameSize = frame.size();
+
+        // Gate and detection, or their cached output.
+        DetectionRecord detection;
+        if(detectionCache.completeHit()){
+            if(!detectionCache.readDetection(frameIndex, detection)){
+                std::cerr << "Error: detection cache has no record for frame " << frameIndex << "\n";
+                break;
+            }
+            detectionCache.countHit();
+        } else {
+            if(cacheEnabled) detectionCache.countMiss();
+            if(gateEnabled){
+                GateDecision gate = frameGate.evaluate(frame);
+                detection.shotCut = gate.isShotCut;
+                detection.skipped = !gate.isPitch;
+                if(gate.isShotCut || !gate.isPitch) backgroundStale = true;
+
+                // The background learnt for the previous shot is meaningless for
+                // the new one: start a fresh model and re-warm it.
+                if(gate.isPitch && backgroundStale){
+                    bgSubtractor = createBackgroundModel(detectorParams);
+                    framesSinceReset = 0;
+                    backgroundEpochStart = frameIndex;
+                    backgroundStale = false;
+                    detection.trackingReset = true;
+                }
+            }
+            if(!detection.skipped){
+                detection.boxes = detectPlayers(frame, bgSubtractor,
+                                                backgroundLearningRate(framesSinceReset, gateEnabled), detectorParams);
+                framesSinceReset++;
+            }
+            if(cacheEnabled) detectionCache.writeDetection(frameIndex, detection);
+        }
+        if(detection.shotCut) shotCutCount++;
+
+        // Crowd shots, close-ups and graphics skip classification and the
+        // heatmap so they neither cost time nor pollute MOG2 and the team anchors.
+        if(detection.skipped){
+            if(skippedRangeStart < 0) skippedRangeStart = frameIndex;
+            skippedFrameCount++;
+            if(exporter)
+                exporter->submit(frameIndex, currentFrame, std::vector<std::pair<cv::Rect,int> >(), std::vector<int>());
+            if(liveEvaluator)
+                liveEvaluator->addFrame(frameIndex, std::vector<std::pair<cv::Rect,int> >());
+            if(liveSource){
+                liveOutput << "{\"frame\":" << frameIndex << ",\"skipped\":true}" << std::endl;
+                latencyHistogram.record(std::chrono::duration<double, std::milli>(
+                    LiveClock::now() - liveFrame.captured).count());
+            }
+            frameIndex++;
+
+            if(showWindows){
+                cv::imshow("Football Player Detection", frame);
+                char key = (char)cv::waitKey(frameDelay);
+                if(key == 27 || key == 'q') break;
+            }
+            continue;
+        }
+
+        if(skippedRangeStart >= 0){
+            skippedCsv << skippedRangeStart << "," << (frameIndex - 1) << "\n";
+            skippedRangeStart = -1;
+        }
+        if(detection.trackingReset) resetPlayerTracking(teamState);
+
+        std::vector<cv::Vec3f> playerFeatures;
+        if(cacheEnabled && featureCache.readFeatures(frameIndex, playerFeatures) &&
+           playerFeatures.size() == detection.boxes.size()){
+            featureCache.countHit();
+        } else {
+            playerFeatures = extractPlayerFeatures(frame, detection.boxes, detectorParams);
+            if(cacheEnabled) featureCache.countMiss();
+        }
+        if(cacheEnabled && !featureCache.completeHit()) featureCache.writeFeatures(frameIndex, playerFeatures);
+
+        std::vector<std::pair<cv::Rect,int> > classifiedPlayers =
+            classifyPlayerFeatures(detection.boxes, playerFeatures, teamState, &trackIds);
+
+        // Live mode publishes each frame as one JSON line and measures the
+        // capture-to-output latency once it has been flushed.
+        if(liveSource){
+            liveOutput << "{\"frame\":" << frameIndex << ",\"players\":[";
+            for(size_t i = 0; i < classifiedPlayers.size(); i++){
+                cv::Rect box = classifiedPlayers[i].first;
+                liveOutput << (i ? "," : "") << "[" << box.x << "," << box.y << ","
+                           << (box.x + box.width) << "," << (box.y + box.height) << ","
+                           << classifiedPlayers[i].second << "]";
+            }
+            liveOutput << "]}" << std::endl;
+
+            LiveClock::time_point now = LiveClock::now();
+            latencyHistogram.record(std::chrono::duration<double, std::milli>(now - liveFrame.captured).count());
+            if(now - lastLatencyReport > std::chrono::seconds(10)){
+                latencyHistogram.print(std::cerr);
+                liveSource->printDropStats(std::cerr);
+                lastLatencyReport = now;
+            }
+        }
 
         // Write detection results to CSV.
         for(size_t i = 0; i < classifiedPlayers.size(); i++){
@@ -68,37 +516,70 @@ int main(int argc, char **argv){
                          << teamLabel << "\n";
         }
 
-        // Draw bounding boxes and team labels on the frame.
-        for(size_t i = 0; i < classifiedPlayers.size(); i++){
-            cv::Rect box = classifiedPlayers[i].first;
-            int teamLabel = classifiedPlayers[i].second;
-            int colorIndex = (teamLabel == 0 || teamLabel == 1) ? teamLabel : 2;
+        if(liveEvaluator) liveEvaluator->addFrame(frameIndex, classifiedPlayers);
 
-            cv::rectangle(frame, box, teamDrawColors[colorIndex], 2);
+        // The exporter shares the unannotated frame and draws on its own copy.
+        if(exporter) exporter->submit(frameIndex, currentFrame, classifiedPlayers, trackIds);
 
-            std::string labelText = (teamLabel == 0) ? "Team A" :
-                                    (teamLabel == 1) ? "Team B" : "Unknown";
-            cv::putText(frame, labelText, box.tl() + cv::Point(0, -5),
-                        cv::FONT_HERSHEY_SIMPLEX, 0.5, teamDrawColors[colorIndex], 1);
-        }
+        // Draw bounding boxes and team labels on a reused display buffer.
+        frame.copyTo(displayFrame);
+        drawPlayerAnnotations(displayFrame, classifiedPlayers, std::vector<int>());
 
         // Save one annotated frame as an example image for the report.
         if(frameIndex == 50)
-            cv::imwrite("detection_example.png", frame);
+            cv::imwrite("detection_example.png", displayFrame);
 
-        heatmap.update(frame, classifiedPlayers);
+        heatmap.update(displayFrame, classifiedPlayers);
+        if(frameIndex % MEMORY_SAMPLE_EVERY == 0)
+            recordMemoryUsage(memoryReport, framePool, detectorParams, frameSize, !detectionCache.completeHit(),
+                              heatmap, displayFrame);
         frameIndex++;
 
-        cv::imshow("Football Player Detection", frame);
-        char key = (char)cv::waitKey(frameDelay);
-        if(key == 27 || key == 'q') break;
+        if(showWindows){
+            cv::imshow("Football Player Detection", displayFrame);
+            char key = (char)cv::waitKey(frameDelay);
+            if(key == 27 || key == 'q') break;
+        }
     }
 
-    heatmap.saveAndShow();
-    cv::waitKey(0);
+    if(skippedRangeStart >= 0)
+        skippedCsv << skippedRangeStart << "," << (frameIndex - 1) << "\n";
+    if(gateEnabled)
+        report << "Gate: skipped " << skippedFrameCount << " of " << frameIndex
+               << " frames, " << shotCutCount << " shot cuts\n";
+
+    if(cacheEnabled){
+        detectionCache.commit(reachedEnd);
+        featureCache.commit(reachedEnd);
+        detectionCache.printStats(report, "detections");
+        featureCache.printStats(report, "features");
+    }
+
+    if(exporter) exporter->finish(report);
+    if(liveEvaluator) liveEvaluator->finish(report);
+    if(liveSource){
+        liveSource->stop();
+        liveSource->printDropStats(report);
+        latencyHistogram.print(report);
+    }
+    framePool.printStats(report);
+    if(frameSize.area() > 0)
+        recordMemoryUsage(memoryReport, framePool, detectorParams, frameSize, !detectionCache.completeHit(),
+                          heatmap, displayFrame);
+    report << "Memory per component:\n";
+    memoryReport.print(report);
+    printProcessMemory(report);
+
+    if(showWindows){
+        heatmap.saveAndShow();
+        cv::waitKey(0);
+    } else {
+        heatmap.save("");
+    }
 
+    skippedCsv.close();
     detectionCsv.close();
     videoCapture.release();
-    cv::destroyAllWindows();
+    if(showWindows) cv::destroyAllWindows();
     return 0;
 }
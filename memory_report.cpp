@@ -0,0 +1,112 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "memory_report.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+static double toMiB(size_t bytes){
+    return bytes / (1024.0 * 1024.0);
+}
+
+void MemoryReport::update(const std::string &component, size_t bytes, bool estimated){
+    for(size_t i = 0; i < components.size(); i++){
+        if(components[i].name != component) continue;
+        components[i].currentBytes = bytes;
+        if(bytes > components[i].peakBytes) components[i].peakBytes = bytes;
+        components[i].estimated = estimated;
+        return;
+    }
+    Component added;
+    added.name = component;
+    added.currentBytes = bytes;
+    added.peakBytes = bytes;
+    added.estimated = estimated;
+    components.push_back(added);
+}
+
+// record — Bytes actually allocated by the component at this moment.
+void MemoryReport::record(const std::string &component, size_t bytes){
+    update(component, bytes, false);
+}
+
+// recordEstimate — Bytes derived from frame size and parameters.
+void MemoryReport::recordEstimate(const std::string &component, size_t bytes){
+    update(component, bytes, true);
+}
+
+size_t MemoryReport::currentTotal() const{
+    size_t total = 0;
+    for(size_t i = 0; i < components.size(); i++) total += components[i].currentBytes;
+    return total;
+}
+
+// Sum of per-component peaks: an upper bound, the peaks need not coincide.
+size_t MemoryReport::peakTotal() const{
+    size_t total = 0;
+    for(size_t i = 0; i < components.size(); i++) total += components[i].peakBytes;
+    return total;
+}
+
+void MemoryReport::print(std::ostream &out) const{
+    char line[160];
+    bool anyEstimated = false;
+    std::snprintf(line, sizeof(line), "  %-20s %12s %12s  %s\n", "component", "steady MiB", "peak MiB", "source");
+    out << line;
+    for(size_t i = 0; i < components.size(); i++){
+        const Component &component = components[i];
+        if(component.estimated){
+            std::snprintf(line, sizeof(line), "  %-20s %12.1f %12s  %s\n", component.name.c_str(),
+                          toMiB(component.currentBytes), "-", "static estimate");
+            anyEstimated = true;
+        } else {
+            std::snprintf(line, sizeof(line), "  %-20s %12.1f %12.1f  %s\n", component.name.c_str(),
+                          toMiB(component.currentBytes), toMiB(component.peakBytes), "measured");
+        }
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), "  %-20s %12.1f %12.1f\n", "total", toMiB(currentTotal()), toMiB(peakTotal()));
+    out << line;
+    if(anyEstimated)
+        out << "  (static estimates are computed from frame size and parameters, not measured, and\n"
+               "   exclude OpenCV-internal temporaries; compare with the process figures below)\n";
+}
+
+bool readProcessMemory(size_t &residentBytes, size_t &peakResidentBytes){
+    std::ifstream status("/proc/self/status");
+    if(!status.is_open()) return false;
+    bool haveResident = false, havePeak = false;
+    std::string line;
+    while(std::getline(status, line)){
+        std::istringstream fields(line);
+        std::string key;
+        size_t kilobytes = 0;
+        if(!(fields >> key >> kilobytes)) continue;
+        if(key == "VmRSS:"){
+            residentBytes = kilobytes * 1024;
+            haveResident = true;
+        } else if(key == "VmHWM:"){
+            peakResidentBytes = kilobytes * 1024;
+            havePeak = true;
+        }
+    }
+    return haveResident && havePeak;
+}
+
+void printProcessMemory(std::ostream &out){
+    size_t residentBytes = 0, peakResidentBytes = 0;
+    if(!readProcessMemory(residentBytes, peakResidentBytes)){
+        out << "Process memory: not available\n";
+        return;
+    }
+    char line[128];
+    std::snprintf(line, sizeof(line), "Process memory: %.1f MiB resident, %.1f MiB peak\n",
+                  toMiB(residentBytes), toMiB(peakResidentBytes));
+    out << line;
+}
@@ -0,0 +1,47 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// MemoryReport — Bytes held by each pipeline component, sampled during a run.
+// Keeps the latest sample (steady state) and the largest one (peak) per
+// component, for per-stream capacity planning. Components whose buffers are
+// not visible to the pipeline (OpenCV's MOG2 state, per-call intermediates)
+// are recorded as estimates computed from frame size and parameters; they
+// have no separate peak and are marked as such in the printout.
+class MemoryReport {
+    struct Component {
+        std::string name;
+        size_t currentBytes;
+        size_t peakBytes;
+        bool estimated;
+    };
+    std::vector<Component> components;
+
+    void update(const std::string &component, size_t bytes, bool estimated);
+
+public:
+    void record(const std::string &component, size_t bytes);
+    void recordEstimate(const std::string &component, size_t bytes);
+    size_t currentTotal() const;
+    size_t peakTotal() const;
+    void print(std::ostream &out) const;
+};
+
+// readProcessMemory — Resident set size and its high-water mark from
+// /proc/self/status (VmRSS, VmHWM). Returns false where that is unavailable.
+bool readProcessMemory(size_t &residentBytes, size_t &peakResidentBytes);
+void printProcessMemory(std::ostream &out);
+
+#endif
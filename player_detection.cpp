@@ -8,75 +8,101 @@
 ********************************************************************************/
 #include "player_detection.h"
 
-// maskGreenField — Segment the playing field using HSV color thresholding.
-// HSV is preferred over RGB because it separates chrominance from luminance,
-// making the green detection robust to illumination changes.
-static cv::Mat maskGreenField(const cv::Mat &hsvFrame){
-    cv::Mat greenMask, dilatedMask, erodedMask, fieldMask;
+// backgroundModelSize — Resolution MOG2 runs at.
+static cv::Size backgroundModelSize(const DetectorParams &params, cv::Size frameSize){
+    if(params.backgroundScale >= 1.0) return frameSize;
+    return cv::Size(std::max(1, cvRound(frameSize.width * params.backgroundScale)),
+                    std::max(1, cvRound(frameSize.height * params.backgroundScale)));
+}
 
-    // HSV green range for the dominant field color.
-    cv::inRange(hsvFrame, cv::Scalar(40,40,40), cv::Scalar(90,255,255), greenMask);
+// classifyColors — HSV conversion and the fused threshold kernel, either on
+// the whole frame or strip by strip into the full-size masks. Both are
+// per-pixel, so the masks are the same either way; strips only bound the
+// size of the HSV copy.
+static void classifyColors(const cv::Mat &frame, cv::Mat &greenMask, cv::Mat &colorMask,
+                           const DetectorParams &params){
+    HsvThresholdKernel thresholdKernel = selectHsvThresholdKernel(params);
+    if(params.tileRows <= 0 || params.tileRows >= frame.rows){
+        cv::Mat hsvFrame;
+        cv::cvtColor(frame, hsvFrame, cv::COLOR_BGR2HSV);
+        thresholdKernel(hsvFrame, greenMask, colorMask, params);
+        return;
+    }
 
-    // Morphological dilation then erosion to fill small holes in the field mask.
-    cv::Mat morphKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(5,5));
-    cv::dilate(greenMask, dilatedMask, morphKernel);
-    cv::erode(dilatedMask, erodedMask, morphKernel);
-    cv::erode(erodedMask, erodedMask, morphKernel);
-    cv::erode(erodedMask, erodedMask, morphKernel);
-    cv::erode(erodedMask, erodedMask, morphKernel);
+    greenMask.create(frame.size(), CV_8UC1);
+    colorMask.create(frame.size(), CV_8UC1);
+    cv::Mat hsvStrip;
+    for(int y = 0; y < frame.rows; y += params.tileRows){
+        cv::Rect strip(0, y, frame.cols, std::min(params.tileRows, frame.rows - y));
+        cv::cvtColor(frame(strip), hsvStrip, cv::COLOR_BGR2HSV);
+        // Same size and type as the kernel's outputs, so it writes in place.
+        cv::Mat greenStrip = greenMask(strip), colorStrip = colorMask(strip);
+        thresholdKernel(hsvStrip, greenStrip, colorStrip, params);
+    }
+}
+
+// maskGreenField — Segment the playing field using HSV color thresholding.
+// HSV is preferred over RGB because it separates chrominance from luminance,
+// making the green detection robust to illumination changes. greenMask is the
+// raw green classification from thresholdHsv; it is used as working memory
+// and holds the eroded mask afterwards.
+static cv::Mat maskGreenField(cv::Mat &greenMask, const DetectorParams &params){
+    cv::Mat fieldMask;
+
+    // Morphological dilation then erosion to fill small holes in the field
+    // mask. fieldMask serves as the dilation buffer before it is filled.
+    cv::Mat morphKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(params.fieldKernel, params.fieldKernel));
+    cv::dilate(greenMask, fieldMask, morphKernel);
+    cv::erode(fieldMask, greenMask, morphKernel);
+    for(int i = 1; i < params.fieldErosions; i++)
+        cv::erode(greenMask, greenMask, morphKernel);
 
     std::vector<std::vector<cv::Point> > fieldContours;
-    cv::findContours(erodedMask, fieldContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    cv::findContours(greenMask, fieldContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
 
-    fieldMask = cv::Mat::zeros(greenMask.size(), CV_8UC1);
+    fieldMask.setTo(cv::Scalar(0));
 
     // Keep green contours above a minimum area threshold to filter noise
     // while preserving the field shape.
     for(size_t i = 0; i < fieldContours.size(); i++){
-        if(cv::contourArea(fieldContours[i]) > 1000.0)
+        if(cv::contourArea(fieldContours[i]) > params.minFieldArea)
             cv::drawContours(fieldMask, fieldContours, (int)i, cv::Scalar(255), cv::FILLED);
     }
 
-    cv::imshow("Green Field Mask", fieldMask);
+    if(params.debugViews) cv::imshow("Green Field Mask", fieldMask);
     return fieldMask;
 }
 
 // maskGreenPlayers — Isolate non-field pixels (potential players) within the
-// field-masked region using color-based segmentation. Inverts a combined mask
-// of green + black + shadow pixels so that only player-colored pixels remain.
-static cv::Mat maskGreenPlayers(const cv::Mat &fieldRegionBgr){
-    cv::Mat hsvImage;
-    cv::cvtColor(fieldRegionBgr, hsvImage, cv::COLOR_BGR2HSV);
-
-    cv::Mat greenMask, blackMask, shadowMask, excludeMask;
-
-    // Remove green field pixels — same HSV range as maskGreenField.
-    cv::inRange(hsvImage, cv::Scalar(40,40,40), cv::Scalar(90,255,255), greenMask);
-
-    // Shadow suppression — shadows have low Value (brightness).
-    // Masking all pixels with V<50 aggressively removes shadow regions.
-    cv::inRange(hsvImage, cv::Scalar(0,0,0), cv::Scalar(180,255,50), shadowMask);
-    cv::inRange(hsvImage, cv::Scalar(0,0,0), cv::Scalar(10,10,10), blackMask);
-
-    cv::bitwise_or(greenMask, blackMask, excludeMask);
-    cv::bitwise_or(excludeMask, shadowMask, excludeMask);
-    cv::bitwise_not(excludeMask, excludeMask);
+// field-masked region. playerColorMask already excludes green, shadow (low
+// Value) and black pixels; outside the field every pixel used to be blacked
+// out before classification, which is the same as intersecting with the
+// field mask, so the frame is converted to HSV only once. The player mask
+// is built in place in playerColorMask.
+static cv::Mat maskGreenPlayers(const cv::Mat &frame, cv::Mat &playerColorMask, const cv::Mat &fieldMask,
+                                const DetectorParams &params){
+    cv::Mat playerMask = playerColorMask;
+    cv::bitwise_and(playerMask, fieldMask, playerMask);
 
     // Dilation to connect nearby player pixels — expands foreground regions,
     // bridging small gaps in the player silhouette.
-    int dilationRadius = 5;
+    int dilationRadius = params.playerDilationRadius;
     cv::Mat dilationKernel = cv::getStructuringElement(
         cv::MORPH_RECT,
         cv::Size(2*dilationRadius+1, 2*dilationRadius+1),
         cv::Point(dilationRadius, dilationRadius)
     );
-    cv::dilate(excludeMask, excludeMask, dilationKernel);
-
-    cv::Mat playerVisualization;
-    fieldRegionBgr.copyTo(playerVisualization, excludeMask);
-    cv::imshow("Players", playerVisualization);
+    cv::dilate(playerMask, playerMask, dilationKernel);
+
+    if(params.debugViews){
+        cv::Mat fieldRegionBgr = cv::Mat::zeros(frame.size(), frame.type());
+        frame.copyTo(fieldRegionBgr, fieldMask);
+        cv::Mat playerVisualization;
+        fieldRegionBgr.copyTo(playerVisualization, playerMask);
+        cv::imshow("Players", playerVisualization);
+    }
 
-    return excludeMask;
+    return playerMask;
 }
 
 // mergeOverlappingBoxes — Agglomerative clustering of overlapping bounding boxes.
@@ -128,29 +154,103 @@ static std::vector<cv::Rect> mergeOverlappingBoxes(const std::vector<cv::Rect> &
     return filteredBoxes;
 }
 
+// detectionStageSignature — Every parameter of the detection pipeline, used to
+// key cached detections and checked when resuming. Derived from the params,
+// so it changes whenever a threshold does.
+std::string detectionStageSignature(const DetectorParams &params){
+    return cv::format("detect-v2 mog2=%d,%g,noshadow,m%d,x%g field=%d,%d,%d-%d,%d,%d,k%d,e%d,area>%g"
+                      " players=green|V<=%d|black<=%d,dilate%d open=ellipse%d area>=%g w=%d..%d h=%d..%d h>=w merge",
+                      params.backgroundHistory, params.backgroundVarThreshold,
+                      params.backgroundMixtures, params.backgroundScale,
+                      params.fieldLow[0], params.fieldLow[1], params.fieldLow[2],
+                      params.fieldHigh[0], params.fieldHigh[1], params.fieldHigh[2],
+                      params.fieldKernel, params.fieldErosions, params.minFieldArea,
+                      params.shadowMaxValue, params.blackMax, 2*params.playerDilationRadius+1,
+                      params.openingKernel, params.minContourArea,
+                      params.minBoxWidth, params.maxBoxWidth, params.minBoxHeight, params.maxBoxHeight);
+}
+
+// createBackgroundModel — MOG2 background subtraction models each pixel as a
+// Mixture of Gaussians to separate moving foreground (players) from static
+// background (field). Shadow detection is off: shadows are removed by colour.
+cv::Ptr<cv::BackgroundSubtractor> createBackgroundModel(const DetectorParams &params){
+    cv::Ptr<cv::BackgroundSubtractorMOG2> model =
+        cv::createBackgroundSubtractorMOG2(params.backgroundHistory, params.backgroundVarThreshold, false);
+    model->setNMixtures(params.backgroundMixtures);
+    return model;
+}
+
+// backgroundLearningRate — With the gate, 1/(n+1) schedule right after a
+// reset, so the first frame of a new shot becomes the background immediately,
+// settling to the steady-state rate of 0.01. Without it, the original
+// constant 0.01 on every frame.
+double backgroundLearningRate(int framesSinceReset, bool gateEnabled){
+    if(!gateEnabled || framesSinceReset >= BACKGROUND_WARMUP_FRAMES) return BACKGROUND_LEARNING_RATE;
+    return std::max(BACKGROUND_LEARNING_RATE, 1.0 / (framesSinceReset + 1));
+}
+
+// updateBackgroundModel — The only stateful step of detection. Kept separate so
+// a resumed run can rebuild the MOG2 model by replaying frames through it
+// without running the rest of the pipeline. A downscaled model is fed an
+// INTER_AREA-reduced frame and its mask is brought back to frame size.
+void updateBackgroundModel(const cv::Mat &frame, cv::Ptr<cv::BackgroundSubtractor> &bgSub,
+                           double learningRate, cv::Mat &foregroundMask, const DetectorParams &params){
+    cv::Size modelSize = backgroundModelSize(params, frame.size());
+    if(modelSize == frame.size()){
+        bgSub->apply(frame, foregroundMask, learningRate);
+        return;
+    }
+    cv::Mat smallFrame, smallMask;
+    cv::resize(frame, smallFrame, modelSize, 0, 0, cv::INTER_AREA);
+    bgSub->apply(smallFrame, smallMask, learningRate);
+    cv::resize(smallMask, foregroundMask, frame.size(), 0, 0, cv::INTER_NEAREST);
+}
+
+// backgroundModelBytes — MOG2 stores backgroundMixtures x (weight, variance,
+// B, G, R) floats and a used-mode count per model pixel, plus the reduced
+// input frame and mask when it runs downscaled.
+size_t backgroundModelBytes(const DetectorParams &params, cv::Size frameSize){
+    cv::Size modelSize = backgroundModelSize(params, frameSize);
+    size_t modelPixels = (size_t)modelSize.area();
+    size_t bytes = modelPixels * (params.backgroundMixtures * 5 * sizeof(float) + 1);
+    if(modelSize != frameSize) bytes += modelPixels * 4;
+    return bytes;
+}
+
+// detectionScratchBytes — Frame-sized 8-bit masks of one detectPlayers call
+// (foreground, green, colour and field) plus the HSV image, whole or one
+// strip. OpenCV-internal temporaries are not included.
+size_t detectionScratchBytes(const DetectorParams &params, cv::Size frameSize){
+    size_t pixels = (size_t)frameSize.area();
+    int hsvRows = (params.tileRows > 0 && params.tileRows < frameSize.height) ? params.tileRows : frameSize.height;
+    return pixels * 4 + (size_t)hsvRows * frameSize.width * 3;
+}
+
 // detectPlayers — Main detection pipeline combining background subtraction,
-// color segmentation, and morphological refinement.
-std::vector<cv::Rect> detectPlayers(const cv::Mat &frame, cv::Ptr<cv::BackgroundSubtractor> &bgSub){
-    cv::Mat foregroundMask, hsvFrame, fieldMask, fieldRegionBgr, playerColorMask, combinedMask;
+// color segmentation, and morphological refinement. The learning rate is
+// raised by the caller while the background model re-warms after a shot cut.
+std::vector<cv::Rect> detectPlayers(const cv::Mat &frame, cv::Ptr<cv::BackgroundSubtractor> &bgSub,
+                                    double learningRate, const DetectorParams &params){
+    // Four frame-sized masks: later stages work in place in these buffers.
+    cv::Mat foregroundMask, greenMask, colorMask, fieldMask, playerColorMask;
 
     // MOG2 background subtraction to extract moving foreground objects.
-    bgSub->apply(frame, foregroundMask, 0.01);
-    cv::cvtColor(frame, hsvFrame, cv::COLOR_BGR2HSV);
-
-    fieldMask = maskGreenField(hsvFrame);
+    updateBackgroundModel(frame, bgSub, learningRate, foregroundMask, params);
 
-    fieldRegionBgr = cv::Mat::zeros(frame.size(), frame.type());
-    frame.copyTo(fieldRegionBgr, fieldMask);
+    // One pass classifies every pixel as green and/or player-coloured.
+    classifyColors(frame, greenMask, colorMask, params);
 
-    playerColorMask = maskGreenPlayers(fieldRegionBgr);
+    fieldMask = maskGreenField(greenMask, params);
+    playerColorMask = maskGreenPlayers(frame, colorMask, fieldMask, params);
 
     // Combine foreground motion mask with player color mask and restrict to field.
-    cv::bitwise_and(foregroundMask, playerColorMask, combinedMask);
+    cv::Mat combinedMask = foregroundMask;
+    cv::bitwise_and(combinedMask, playerColorMask, combinedMask);
     cv::bitwise_and(combinedMask, fieldMask, combinedMask);
 
     // Morphological opening (erosion + dilation) eliminates small noise blobs
     // and thin shadow remnants from the combined mask.
-    cv::Mat openingKernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5,5));
+    cv::Mat openingKernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(params.openingKernel, params.openingKernel));
     cv::morphologyEx(combinedMask, combinedMask, cv::MORPH_OPEN, openingKernel);
 
     // Contour extraction and bounding box filtering — external contours
@@ -162,13 +262,13 @@ std::vector<cv::Rect> detectPlayers(const cv::Mat &frame, cv::Ptr<cv::Background
     for(size_t i = 0; i < contours.size(); i++){
         // Area filter: reject small noise blobs.
         double contourArea = cv::contourArea(contours[i]);
-        if(contourArea < 30) continue;
+        if(contourArea < params.minContourArea) continue;
 
         cv::Rect boundingBox = cv::boundingRect(contours[i]);
 
         // Size constraints: player bounding boxes fall within typical pixel dimensions.
-        if(boundingBox.width < 10 || boundingBox.height < 20 ||
-           boundingBox.width > 100 || boundingBox.height > 200) continue;
+        if(boundingBox.width < params.minBoxWidth || boundingBox.height < params.minBoxHeight ||
+           boundingBox.width > params.maxBoxWidth || boundingBox.height > params.maxBoxHeight) continue;
 
         // Aspect ratio constraint — players are taller than wide;
         // shadows are wide and flat.
@@ -9,6 +9,25 @@
 #ifndef PLAYER_DETECTION_H
 #define PLAYER_DETECTION_H
 #include <opencv2/opencv.hpp>
+#include <string>
 #include <vector>
-std::vector<cv::Rect> detectPlayers(const cv::Mat &frame, cv::Ptr<cv::BackgroundSubtractor> &bgSub);
+#include "detector_profile.h"
+std::vector<cv::Rect> detectPlayers(const cv::Mat &frame, cv::Ptr<cv::BackgroundSubtractor> &bgSub,
+                                    double learningRate = 0.01,
+                                    const DetectorParams &params = defaultDetectorParams());
+cv::Ptr<cv::BackgroundSubtractor> createBackgroundModel(const DetectorParams &params = defaultDetectorParams());
+// Number of pitch frames after a background reset during which the model is
+// re-warmed with a decaying, higher-than-normal learning rate. Only the gated
+// pipeline resets the model; without the gate the rate is a constant 0.01.
+const int BACKGROUND_WARMUP_FRAMES = 100;
+const double BACKGROUND_LEARNING_RATE = 0.01;
+double backgroundLearningRate(int framesSinceReset, bool gateEnabled);
+std::string detectionStageSignature(const DetectorParams &params = defaultDetectorParams());
+void updateBackgroundModel(const cv::Mat &frame, cv::Ptr<cv::BackgroundSubtractor> &bgSub,
+                           double learningRate, cv::Mat &foregroundMask,
+                           const DetectorParams &params = defaultDetectorParams());
+// Estimated bytes held by the background model, and by the per-frame
+// intermediates of detectPlayers, for frames of the given size.
+size_t backgroundModelBytes(const DetectorParams &params, cv::Size frameSize);
+size_t detectionScratchBytes(const DetectorParams &params, cv::Size frameSize);
 #endif
@@ -7,8 +7,10 @@
          No external source code beyond standard libraries and OpenCV.
 ********************************************************************************/
 #include "player_heatmap.h"
+#include "binary_io.h"
 
-Heatmap::Heatmap(){
+Heatmap::Heatmap(double accumulatorScale) : scale(accumulatorScale){
+    if(scale <= 0.0 || scale > 1.0) scale = 1.0;
     // Team A = red, Team B = blue, Unknown = green (BGR format).
     colors.push_back(cv::Scalar(0, 0, 255));
     colors.push_back(cv::Scalar(255, 0, 0));
@@ -18,44 +20,85 @@ Heatmap::Heatmap(){
 // update — Accumulate team-colored circles at each detection center into a
 // floating-point image. This builds a spatial density map of player positions
 // by estimating the underlying density of player locations from discrete
-// observations.
+// observations. Each circle is drawn on a small layer covering just its
+// bounding box and added to that part of the accumulator, which gives the
+// same sums as a frame-sized layer per player.
 void Heatmap::update(const cv::Mat &frame, const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers){
     if(accum.empty()){
-        accum = cv::Mat::zeros(frame.size(), CV_32FC3);
-        first = frame.clone();
+        cv::Size accumSize(std::max(1, cvRound(frame.cols * scale)), std::max(1, cvRound(frame.rows * scale)));
+        accum = cv::Mat::zeros(accumSize, CV_32FC3);
+        if(accumSize == frame.size()) first = frame.clone();
+        else cv::resize(frame, first, accumSize, 0, 0, cv::INTER_AREA);
     }
 
-    for(size_t i = 0; i < classifiedPlayers.size(); i++){
-        cv::Mat detectionLayer = cv::Mat::zeros(frame.size(), CV_32FC3);
+    double scaleX = (double)accum.cols / frame.cols, scaleY = (double)accum.rows / frame.rows;
+    int radius = std::max(1, cvRound(20 * scaleX));
+    cv::Rect accumArea(0, 0, accum.cols, accum.rows);
 
+    for(size_t i = 0; i < classifiedPlayers.size(); i++){
         int teamIndex = classifiedPlayers[i].second;
         if(teamIndex < 0 || teamIndex >= (int)colors.size())
             teamIndex = 2; // Unknown -> green
 
         cv::Point playerCenter = (classifiedPlayers[i].first.tl() + classifiedPlayers[i].first.br()) * 0.5;
-        cv::circle(detectionLayer, playerCenter, 20, colors[teamIndex], -1, cv::LINE_AA);
+        if(accum.size() != frame.size())
+            playerCenter = cv::Point(cvRound(playerCenter.x * scaleX), cvRound(playerCenter.y * scaleY));
+
+        // Anti-aliased edges reach one pixel past the radius; keep a margin.
+        int reach = radius + 2;
+        cv::Rect layerArea = cv::Rect(playerCenter.x - reach, playerCenter.y - reach, 2*reach + 1, 2*reach + 1)
+                           & accumArea;
+        if(layerArea.area() <= 0) continue;
+
+        detectionLayer.create(layerArea.size(), CV_32FC3);
+        detectionLayer.setTo(cv::Scalar::all(0));
+        cv::circle(detectionLayer, playerCenter - layerArea.tl(), radius, colors[teamIndex], -1, cv::LINE_AA);
 
-        accum += detectionLayer;
+        cv::Mat accumRegion = accum(layerArea);
+        accumRegion += detectionLayer;
     }
 }
 
-// saveAndShow — Smooth the accumulated heatmap with a Gaussian kernel and
-// overlay it on the first frame for visualization.
-void Heatmap::saveAndShow(){
-    if(accum.empty()) return;
+// render — Smooth the accumulated heatmap with a Gaussian kernel and map it to
+// an 8-bit BGR image. Returns false while nothing has been accumulated yet.
+bool Heatmap::render(cv::Mat &heatmapImage) const{
+    if(accum.empty()) return false;
 
-    cv::Mat blurredHeatmap, heatmapImage, overlayImage;
+    cv::Mat blurredHeatmap;
 
     // Gaussian smoothing to turn discrete detection points into a continuous
     // density visualization.
-    cv::GaussianBlur(accum, blurredHeatmap, cv::Size(0, 0), 15);
+    cv::GaussianBlur(accum, blurredHeatmap, cv::Size(0, 0), 15 * scale);
 
     // Intensity normalization — map pixel values to the full [0,255] range
     // to maximize visual contrast.
     cv::normalize(blurredHeatmap, blurredHeatmap, 0, 255, cv::NORM_MINMAX);
     blurredHeatmap.convertTo(heatmapImage, CV_8UC3);
+    return true;
+}
 
+// renderOverlay — The heatmap and the heatmap blended over the first frame.
+bool Heatmap::renderOverlay(cv::Mat &heatmapImage, cv::Mat &overlayImage) const{
+    if(!render(heatmapImage)) return false;
     cv::addWeighted(first, 0.5, heatmapImage, 0.5, 0, overlayImage);
+    return true;
+}
+
+// save — Write combined_heatmap.png and heatmap_overlay.png without opening
+// any window, for headless runs. prefix is prepended to both file names
+// (e.g. "out/match1/").
+bool Heatmap::save(const std::string &prefix) const{
+    cv::Mat heatmapImage, overlayImage;
+    if(!renderOverlay(heatmapImage, overlayImage)) return false;
+    return cv::imwrite(prefix + "combined_heatmap.png", heatmapImage)
+        && cv::imwrite(prefix + "heatmap_overlay.png", overlayImage);
+}
+
+// saveAndShow — Render the heatmap and overlay it on the first frame for
+// visualization.
+void Heatmap::saveAndShow(){
+    cv::Mat heatmapImage, overlayImage;
+    if(!renderOverlay(heatmapImage, overlayImage)) return;
 
     cv::namedWindow("Combined Heatmap", cv::WINDOW_NORMAL);
     cv::namedWindow("Heatmap Overlay", cv::WINDOW_NORMAL);
@@ -66,3 +109,38 @@ void Heatmap::saveAndShow(){
     cv::imwrite("combined_heatmap.png", heatmapImage);
     cv::imwrite("heatmap_overlay.png", overlayImage);
 }
+
+
+// saveState / loadState — Compressed accumulator, for checkpoints. The first
+// frame never changes once set, so it is saved separately and only once.
+void Heatmap::saveState(std::ostream &out) const{
+    writeCompressedMat(out, accum);
+}
+
+bool Heatmap::loadState(std::istream &in){
+    return readCompressedMat(in, accum);
+}
+
+bool Heatmap::hasFirstFrame() const{
+    return !first.empty();
+}
+
+// saveFirstFrame / loadFirstFrame — The background of the overlay as a PNG.
+// Nothing is read while the accumulator is still empty.
+bool Heatmap::saveFirstFrame(const std::string &path) const{
+    return !first.empty() && cv::imwrite(path, first);
+}
+
+bool Heatmap::loadFirstFrame(const std::string &path){
+    if(accum.empty()){
+        first.release();
+        return true;
+    }
+    first = cv::imread(path, cv::IMREAD_COLOR);
+    return first.size() == accum.size();
+}
+
+size_t Heatmap::memoryBytes() const{
+    return accum.total() * accum.elemSize() + first.total() * first.elemSize()
+         + detectionLayer.total() * detectionLayer.elemSize();
+}
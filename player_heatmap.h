@@ -10,17 +10,39 @@
 #define PLAYER_HEATMAP_H
 
 #include <opencv2/opencv.hpp>
+#include <istream>
+#include <ostream>
+#include <string>
 #include <vector>
 
+// Heatmap accumulator scale used by --low-memory: a 4K frame accumulates at
+// 960x540, 6 MiB of float instead of 95 MiB.
+const double LOW_MEMORY_HEATMAP_SCALE = 0.25;
+
+// Heatmap — Player density per team. With scale < 1 the accumulator, the
+// background frame and the saved images are kept at that fraction of the
+// frame size, and the circle radius and blur shrink with it.
 class Heatmap {
+    double scale;
     cv::Mat accum;
     cv::Mat first;
+    cv::Mat detectionLayer;
     std::vector<cv::Scalar> colors;
 
+    bool renderOverlay(cv::Mat &heatmapImage, cv::Mat &overlayImage) const;
+
 public:
-    Heatmap();
+    explicit Heatmap(double accumulatorScale = 1.0);
     void update(const cv::Mat &frame, const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers);
+    bool render(cv::Mat &heatmapImage) const;
+    bool save(const std::string &prefix) const;
     void saveAndShow();
+    void saveState(std::ostream &out) const;
+    bool loadState(std::istream &in);
+    bool hasFirstFrame() const;
+    bool saveFirstFrame(const std::string &path) const;
+    bool loadFirstFrame(const std::string &path);
+    size_t memoryBytes() const;
 };
 
 #endif
@@ -0,0 +1,186 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "stage_cache.h"
+#include "binary_io.h"
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+
+static const char CACHE_MAGIC[4] = {'S', 'V', 'S', 'C'};
+static const int CACHE_VERSION = 1;
+static const unsigned char FLAG_SKIPPED = 1, FLAG_SHOT_CUT = 2, FLAG_TRACKING_RESET = 4;
+
+// Bytes hashed from each end of the video file for its fingerprint.
+static const size_t FINGERPRINT_SPAN = 1 << 20;
+
+static cv::uint64 fnv1a(const char *data, size_t length, cv::uint64 hash = 14695981039346656037ULL){
+    for(size_t i = 0; i < length; i++){
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static std::string toHex(cv::uint64 value){
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", (unsigned long long)value);
+    return text;
+}
+
+// fingerprintVideo — Hash of the file size and its first and last megabyte:
+// cheap on multi-gigabyte files, and any re-encode or trim changes it.
+std::string fingerprintVideo(const std::string &videoPath){
+    std::ifstream in(videoPath.c_str(), std::ios::binary);
+    if(!in.is_open()) return "";
+    in.seekg(0, std::ios::end);
+    long long fileSize = (long long)in.tellg();
+
+    std::vector<char> span(FINGERPRINT_SPAN);
+    cv::uint64 hash = fnv1a(reinterpret_cast<const char*>(&fileSize), sizeof(fileSize));
+    in.seekg(0);
+    in.read(span.data(), (std::streamsize)span.size());
+    hash = fnv1a(span.data(), (size_t)in.gcount(), hash);
+    in.clear();
+    in.seekg(std::max(0LL, fileSize - (long long)FINGERPRINT_SPAN));
+    in.read(span.data(), (std::streamsize)span.size());
+    hash = fnv1a(span.data(), (size_t)in.gcount(), hash);
+    return toHex(hash);
+}
+
+StageCache::StageCache() : elementBytes(0), readerComplete(false), readerFrame(-1), hitCount(0), missCount(0) {}
+
+// open — Look for an existing cache file for this key.
+void StageCache::open(const std::string &cacheDir, const std::string &videoFingerprint,
+                      const std::string &stageName, const std::string &stageSignature, size_t payloadElementBytes){
+    signature = stageSignature;
+    elementBytes = payloadElementBytes;
+    std::string stem = videoFingerprint + "-" + stageName + "-" + toHex(fnv1a(signature.data(), signature.size()));
+    finalPath = (std::filesystem::path(cacheDir) / (stem + ".svc")).string();
+    temporaryPath = finalPath + ".tmp";
+
+    reader.open(finalPath.c_str(), std::ios::binary);
+    if(reader.is_open()){
+        char magic[4];
+        int version = 0;
+        std::string storedSignature;
+        reader.read(magic, sizeof(magic));
+        bool valid = reader && std::equal(magic, magic + 4, CACHE_MAGIC)
+            && readBinary(reader, version) && version == CACHE_VERSION
+            && readString(reader, storedSignature) && storedSignature == signature
+            && readBinary(reader, readerComplete);
+        if(!valid){
+            reader.close();
+            readerComplete = false;
+        } else if(!readBinary(reader, readerFrame)){
+            readerFrame = -1;
+        }
+    }
+
+}
+
+// startWriting — Begin a new cache file for this key, written to a temporary
+// name and renamed over the old one on commit.
+bool StageCache::startWriting(){
+    std::error_code ignored;
+    std::filesystem::create_directories(std::filesystem::path(finalPath).parent_path(), ignored);
+    writer.open(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+    if(!writer.is_open()) return false;
+    writer.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    writeBinary(writer, CACHE_VERSION);
+    writeString(writer, signature);
+    writeBinary(writer, false);     // patched to true by commit() for whole-video files
+    return true;
+}
+
+// advanceReaderTo — Records are stored in frame order; skip ahead to the one
+// for frameIndex. The frame number of the next record is read ahead.
+bool StageCache::advanceReaderTo(int frameIndex){
+    while(reader.is_open() && readerFrame >= 0 && readerFrame < frameIndex){
+        unsigned char flags;
+        unsigned int count;
+        if(!readBinary(reader, flags) || !readBinary(reader, count)){
+            readerFrame = -1;
+            break;
+        }
+        reader.seekg((std::streamoff)(count * elementBytes), std::ios::cur);
+        if(!readBinary(reader, readerFrame)) readerFrame = -1;
+    }
+    return reader.is_open() && readerFrame == frameIndex;
+}
+
+bool StageCache::readDetection(int frameIndex, DetectionRecord &record){
+    if(!advanceReaderTo(frameIndex)) return false;
+    unsigned char flags;
+    unsigned int count;
+    if(!readBinary(reader, flags) || !readBinary(reader, count)) return false;
+    record.skipped = (flags & FLAG_SKIPPED) != 0;
+    record.shotCut = (flags & FLAG_SHOT_CUT) != 0;
+    record.trackingReset = (flags & FLAG_TRACKING_RESET) != 0;
+    record.boxes.resize(count);
+    for(unsigned int i = 0; i < count; i++)
+        if(!readBinary(reader, record.boxes[i])) return false;
+    if(!readBinary(reader, readerFrame)) readerFrame = -1;
+    return true;
+}
+
+bool StageCache::readFeatures(int frameIndex, std::vector<cv::Vec3f> &features){
+    if(!advanceReaderTo(frameIndex)) return false;
+    unsigned char flags;
+    unsigned int count;
+    if(!readBinary(reader, flags) || !readBinary(reader, count)) return false;
+    features.resize(count);
+    for(unsigned int i = 0; i < count; i++)
+        if(!readBinary(reader, features[i])) return false;
+    if(!readBinary(reader, readerFrame)) readerFrame = -1;
+    return true;
+}
+
+void StageCache::writeDetection(int frameIndex, const DetectionRecord &record){
+    if(!writer.is_open()) return;
+    unsigned char flags = (record.skipped ? FLAG_SKIPPED : 0) | (record.shotCut ? FLAG_SHOT_CUT : 0)
+                        | (record.trackingReset ? FLAG_TRACKING_RESET : 0);
+    writeBinary(writer, frameIndex);
+    writeBinary(writer, flags);
+    writeBinary(writer, (unsigned int)record.boxes.size());
+    for(size_t i = 0; i < record.boxes.size(); i++)
+        writeBinary(writer, record.boxes[i]);
+}
+
+void StageCache::writeFeatures(int frameIndex, const std::vector<cv::Vec3f> &features){
+    if(!writer.is_open()) return;
+    writeBinary(writer, frameIndex);
+    writeBinary(writer, (unsigned char)0);
+    writeBinary(writer, (unsigned int)features.size());
+    for(size_t i = 0; i < features.size(); i++)
+        writeBinary(writer, features[i]);
+}
+
+// commit — Publish the new cache file. A file that does not cover the whole
+// video only replaces one that does not either.
+void StageCache::commit(bool coversWholeVideo){
+    if(!writer.is_open()) return;
+    std::streamoff completeFlagOffset = sizeof(CACHE_MAGIC) + sizeof(int) + sizeof(int) + signature.size();
+    writer.seekp(completeFlagOffset);
+    writeBinary(writer, coversWholeVideo);
+    writer.close();
+    reader.close();
+
+    if(!coversWholeVideo && readerComplete){
+        std::remove(temporaryPath.c_str());
+        return;
+    }
+    std::rename(temporaryPath.c_str(), finalPath.c_str());
+}
+
+void StageCache::printStats(std::ostream &out, const std::string &stageName) const{
+    long total = hitCount + missCount;
+    out << "Cache " << stageName << ": " << hitCount << "/" << total << " frames hit ("
+        << std::fixed << std::setprecision(1) << (total ? 100.0 * hitCount / total : 0.0) << "%)\n";
+    out.unsetf(std::ios::floatfield);
+}
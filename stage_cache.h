@@ -0,0 +1,76 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef STAGE_CACHE_H
+#define STAGE_CACHE_H
+
+#include <opencv2/opencv.hpp>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Output of the gate + detection stage for one frame. The flags carry what
+// later stages need to replay the run without the background model: whether
+// the frame was skipped, whether it starts a new shot, and whether tracking
+// was reset before it.
+struct DetectionRecord {
+    bool skipped;
+    bool shotCut;
+    bool trackingReset;
+    std::vector<cv::Rect> boxes;
+
+    DetectionRecord() : skipped(false), shotCut(false), trackingReset(false) {}
+};
+
+std::string fingerprintVideo(const std::string &videoPath);
+
+// StageCache — Content-addressed on-disk cache of one stage's per-frame
+// outputs. A cache file is named after the video fingerprint, the stage name
+// and a hash of the stage's parameter signature (which includes the
+// signatures of the stages it depends on), and stores one record per frame:
+//   int32 frame, uint8 flags, uint32 count, count x payload
+// Payloads are cv::Rect (detections) or cv::Vec3f (jersey features).
+//
+// Detections are only reused when the file covers the whole video: the
+// background model cannot be restarted in the middle. Features are stateless,
+// so a partial file still serves the frames it has.
+class StageCache {
+    std::string finalPath;
+    std::string temporaryPath;
+    std::string signature;
+    size_t elementBytes;
+    std::ifstream reader;
+    std::ofstream writer;
+    bool readerComplete;
+    int readerFrame;            // frame of the record under the read cursor
+
+    long hitCount;
+    long missCount;
+
+    bool advanceReaderTo(int frameIndex);
+
+public:
+    StageCache();
+    void open(const std::string &cacheDir, const std::string &videoFingerprint,
+              const std::string &stageName, const std::string &stageSignature, size_t payloadElementBytes);
+    bool startWriting();
+    bool completeHit() const { return readerComplete; }
+
+    bool readDetection(int frameIndex, DetectionRecord &record);
+    bool readFeatures(int frameIndex, std::vector<cv::Vec3f> &features);
+    void writeDetection(int frameIndex, const DetectionRecord &record);
+    void writeFeatures(int frameIndex, const std::vector<cv::Vec3f> &features);
+
+    void countHit() { hitCount++; }
+    void countMiss() { missCount++; }
+    void commit(bool coversWholeVideo);
+    void printStats(std::ostream &out, const std::string &stageName) const;
+};
+
+#endif
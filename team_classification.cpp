@@ -9,47 +9,65 @@
 #include "team_classification.h"
 #include <map>
 
-static std::vector<cv::Mat> teamFeatureAnchors;
-static int anchorFrameCount = 0;
 static const int MAX_ANCHOR_FRAMES = 10;
-static bool teamAnchorsInitialized = false;
-static std::map<int, std::pair<cv::Rect,int> > previousFrameBoxes;
-static int nextTrackingID = 0;
 static const int NUM_TEAMS = 2;
 
+// State used by the single-stream overloads.
+static TeamClassifierState defaultClassifierState;
+
+// JerseyScratch — Working images of the feature stage. One set per thread,
+// reused for every player, so steady-state extraction allocates nothing once
+// the buffers have grown to the ROI size.
+struct JerseyScratch {
+    cv::Mat playerRoi;
+    cv::Mat hsvJersey;
+    cv::Mat greenMask;
+    cv::Mat playerColorMask;
+    cv::Mat labImage;
+    std::vector<float> lightness, channelA, channelB;
+};
+
 // extractJerseyColorFeature — Extract a CIELab color feature vector from the
 // upper body (jersey) region of a player ROI, excluding green field pixels and
 // shadow pixels. CIELab is perceptually uniform, meaning Euclidean distance in
 // Lab space correlates with perceived color difference.
-static cv::Vec3f extractJerseyColorFeature(const cv::Mat &playerRoi){
-    // Focus on upper 60% of ROI — the jersey/shirt area is most discriminative
-    // for team classification. Lower body (shorts, legs, feet) adds noise.
-    int jerseyHeight = (int)(playerRoi.rows * 0.6);
+static cv::Vec3f extractJerseyColorFeature(const cv::Mat &playerRoi, const DetectorParams &params,
+                                           HsvThresholdKernel thresholdKernel, JerseyScratch &scratch){
+    // Focus on the upper part of the ROI (60% by default) — the jersey/shirt
+    // area is most discriminative for team classification. Lower body
+    // (shorts, legs, feet) adds noise.
+    int jerseyHeight = (int)(playerRoi.rows * params.jerseyFraction);
     if(jerseyHeight < 1) jerseyHeight = playerRoi.rows;
     cv::Mat jerseyRegion = playerRoi(cv::Rect(0, 0, playerRoi.cols, jerseyHeight));
 
-    cv::Mat hsvJersey;
-    cv::cvtColor(jerseyRegion, hsvJersey, cv::COLOR_BGR2HSV);
+    cv::cvtColor(jerseyRegion, scratch.hsvJersey, cv::COLOR_BGR2HSV);
 
-    // Mask out green field pixels and shadow pixels within the ROI (shadows have V<50).
-    cv::Mat greenMask, shadowMask, excludeMask;
-    cv::inRange(hsvJersey, cv::Scalar(40,40,40), cv::Scalar(90,255,255), greenMask);
-    cv::inRange(hsvJersey, cv::Scalar(0,0,0), cv::Scalar(180,255,50), shadowMask);
-    cv::bitwise_or(greenMask, shadowMask, excludeMask);
+    // Keep only pixels that are neither green field nor shadow (low V). The
+    // kernel's player-colour mask also drops black, which a parameter file
+    // may set above the shadow level, so only its green mask is used.
+    thresholdKernel(scratch.hsvJersey, scratch.greenMask, scratch.playerColorMask, params);
+    const uchar shadowMax = (uchar)params.shadowMaxValue;
 
-    // Convert to CIELab for perceptually uniform color features.
-    cv::Mat labImage;
-    cv::cvtColor(jerseyRegion, labImage, cv::COLOR_BGR2Lab);
-    labImage.convertTo(labImage, CV_32F);
-    cv::Mat labPixels = labImage.reshape(1, labImage.rows * labImage.cols);
+    // Convert to CIELab for perceptually uniform color features. The 8-bit
+    // values are collected as floats directly, which is what converting the
+    // whole image to CV_32F first produced.
+    cv::cvtColor(jerseyRegion, scratch.labImage, cv::COLOR_BGR2Lab);
+    const cv::Vec3b *labPixels = scratch.labImage.ptr<cv::Vec3b>(0);
+    const cv::Vec3b *hsvPixels = scratch.hsvJersey.ptr<cv::Vec3b>(0);
+    const uchar *green = scratch.greenMask.ptr<uchar>(0);
+    int pixelCount = (int)scratch.labImage.total();
 
-    std::vector<float> lightness, channelA, channelB;
-    for(int i = 0; i < labPixels.rows; i++){
-        if(excludeMask.at<uchar>(i) == 0){
-            cv::Vec3f pixel = labPixels.at<cv::Vec3f>(i);
-            lightness.push_back(pixel[0]);
-            channelA.push_back(pixel[1]);
-            channelB.push_back(pixel[2]);
+    std::vector<float> &lightness = scratch.lightness;
+    std::vector<float> &channelA = scratch.channelA;
+    std::vector<float> &channelB = scratch.channelB;
+    lightness.clear();
+    channelA.clear();
+    channelB.clear();
+    for(int i = 0; i < pixelCount; i++){
+        if(green[i] == 0 && hsvPixels[i][2] > shadowMax){
+            lightness.push_back(labPixels[i][0]);
+            channelA.push_back(labPixels[i][1]);
+            channelB.push_back(labPixels[i][2]);
         }
     }
 
@@ -90,11 +108,26 @@ static int findClosestTrackedPlayer(const cv::Rect &currentBox,
 // clustering on CIELab color features. Partitions data into k=2 clusters by
 // minimizing within-cluster sum of squares. Temporal anchoring stabilizes
 // cluster assignments across frames by maintaining an exponential moving
-// average of cluster centers over the first 10 frames.
-std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame, const std::vector<cv::Rect> &boxes){
-    // Extract color features for each detected player.
+// average of cluster centers over the first 10 frames. When trackIds is given
+// it receives the tracking ID of each returned player, in the same order.
+std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame, const std::vector<cv::Rect> &boxes,
+                                                       std::vector<int> *trackIds){
+    return classifyPlayers(frame, boxes, defaultClassifierState, trackIds);
+}
+
+std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame, const std::vector<cv::Rect> &boxes,
+                                                       TeamClassifierState &state, std::vector<int> *trackIds){
+    return classifyPlayerFeatures(boxes, extractPlayerFeatures(frame, boxes), state, trackIds);
+}
+
+// extractPlayerFeatures — One jersey color feature per box. Depends only on
+// the frame pixels inside each box, so results can be cached per frame.
+std::vector<cv::Vec3f> extractPlayerFeatures(const cv::Mat &frame, const std::vector<cv::Rect> &boxes,
+                                             const DetectorParams &params){
     std::vector<cv::Vec3f> playerFeatures;
     playerFeatures.reserve(boxes.size());
+    HsvThresholdKernel thresholdKernel = selectHsvThresholdKernel(params);
+    static thread_local JerseyScratch scratch;
 
     for(size_t i = 0; i < boxes.size(); i++){
         cv::Rect safeBox = boxes[i] & cv::Rect(0, 0, frame.cols, frame.rows);
@@ -102,10 +135,28 @@ std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame, cons
             playerFeatures.push_back(cv::Vec3f(0, 0, 0));
             continue;
         }
-        cv::Mat playerRoi = frame(safeBox);
-        cv::resize(playerRoi, playerRoi, cv::Size(32, 64));
-        playerFeatures.push_back(extractJerseyColorFeature(playerRoi));
+        // The frame is shared with other stages: resize into scratch, never in place.
+        cv::resize(frame(safeBox), scratch.playerRoi, params.featureRoi);
+        playerFeatures.push_back(extractJerseyColorFeature(scratch.playerRoi, params, thresholdKernel, scratch));
     }
+    return playerFeatures;
+}
+
+// featureStageSignature — Every parameter extractPlayerFeatures depends on,
+// used to key cached features.
+std::string featureStageSignature(const DetectorParams &params){
+    return cv::format("jersey-v2 roi=%dx%d top=%g green=%d,%d,%d-%d,%d,%d shadowV<=%d black<=%d lab-median",
+                      params.featureRoi.width, params.featureRoi.height, params.jerseyFraction,
+                      params.fieldLow[0], params.fieldLow[1], params.fieldLow[2],
+                      params.fieldHigh[0], params.fieldHigh[1], params.fieldHigh[2],
+                      params.shadowMaxValue, params.blackMax);
+}
+
+// classifyPlayerFeatures — Team assignment from precomputed features.
+std::vector<std::pair<cv::Rect,int> > classifyPlayerFeatures(const std::vector<cv::Rect> &boxes,
+                                                              const std::vector<cv::Vec3f> &playerFeatures,
+                                                              TeamClassifierState &state, std::vector<int> *trackIds){
+    if(trackIds) trackIds->clear();
 
     if(playerFeatures.empty()) return std::vector<std::pair<cv::Rect,int> >();
 
@@ -122,27 +173,34 @@ std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame, cons
     cv::Mat clusterLabels, clusterCenters;
 
     // K-means clustering with k=2 for two teams, KMEANS_PP_CENTERS for smart
-    // initialization, 5 attempts to avoid local minima.
+    // initialization, 5 attempts to avoid local minima. k-means draws from
+    // cv::theRNG(); the stream's own random state is swapped in so results do
+    // not depend on which thread or which other streams ran before.
+    cv::RNG &threadRng = cv::theRNG();
+    cv::uint64 threadRngState = threadRng.state;
+    threadRng.state = state.rngState;
     cv::kmeans(featureMatrix, NUM_TEAMS, clusterLabels,
                cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 10, 1.0),
                5, cv::KMEANS_PP_CENTERS, clusterCenters);
+    state.rngState = threadRng.state;
+    threadRng.state = threadRngState;
 
     // Update temporal anchors with exponential moving average over the first frames.
-    if(anchorFrameCount < MAX_ANCHOR_FRAMES){
-        if(teamFeatureAnchors.empty()){
+    if(state.anchorFrameCount < MAX_ANCHOR_FRAMES){
+        if(state.teamFeatureAnchors.empty()){
             for(int i = 0; i < clusterCenters.rows; i++)
-                teamFeatureAnchors.push_back(clusterCenters.row(i).clone());
+                state.teamFeatureAnchors.push_back(clusterCenters.row(i).clone());
         } else {
             for(int i = 0; i < clusterCenters.rows; i++){
-                if(teamFeatureAnchors[i].size() != clusterCenters.row(i).size() ||
-                   teamFeatureAnchors[i].type() != clusterCenters.row(i).type())
-                    teamFeatureAnchors[i] = clusterCenters.row(i).clone();
+                if(state.teamFeatureAnchors[i].size() != clusterCenters.row(i).size() ||
+                   state.teamFeatureAnchors[i].type() != clusterCenters.row(i).type())
+                    state.teamFeatureAnchors[i] = clusterCenters.row(i).clone();
                 else
-                    teamFeatureAnchors[i] = teamFeatureAnchors[i] * 0.9f + clusterCenters.row(i) * 0.1f;
+                    state.teamFeatureAnchors[i] = state.teamFeatureAnchors[i] * 0.9f + clusterCenters.row(i) * 0.1f;
             }
         }
-        anchorFrameCount++;
-        if(anchorFrameCount == MAX_ANCHOR_FRAMES) teamAnchorsInitialized = true;
+        state.anchorFrameCount++;
+        if(state.anchorFrameCount == MAX_ANCHOR_FRAMES) state.teamAnchorsInitialized = true;
     }
 
     // Map k-means cluster indices to stable team IDs using anchor similarity.
@@ -154,7 +212,7 @@ std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame, cons
         int bestCluster = -1;
         for(int clusterIdx = 0; clusterIdx < NUM_TEAMS; clusterIdx++){
             if(teamAssigned[clusterIdx]) continue;
-            float dist = cv::norm(teamFeatureAnchors[anchorIdx] - clusterCenters.row(clusterIdx));
+            float dist = cv::norm(state.teamFeatureAnchors[anchorIdx] - clusterCenters.row(clusterIdx));
             if(dist < minDist){
                 minDist = dist;
                 bestCluster = clusterIdx;
@@ -181,22 +239,35 @@ std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame, cons
         float distToOtherCluster = cv::norm(featureMatrix.row(i) - clusterCenters.row(1 - rawCluster));
         float confidenceRatio = (distToOtherCluster > 0) ? (distToOwnCluster / distToOtherCluster) : 0;
 
-        int matchedTrackID = findClosestTrackedPlayer(boxes[i], previousFrameBoxes);
+        int matchedTrackID = findClosestTrackedPlayer(boxes[i], state.previousFrameBoxes);
 
         if(matchedTrackID != -1){
             // Only inherit previous frame's label when k-means is uncertain
             // (confidence ratio > 0.7 means clusters are close for this player).
             // When k-means is confident, trust the current color evidence.
-            if(confidenceRatio > 0.7 && previousFrameBoxes.at(matchedTrackID).second != teamLabel)
-                teamLabel = previousFrameBoxes.at(matchedTrackID).second;
+            if(confidenceRatio > 0.7 && state.previousFrameBoxes.at(matchedTrackID).second != teamLabel)
+                teamLabel = state.previousFrameBoxes.at(matchedTrackID).second;
             currentFrameBoxes[matchedTrackID] = std::make_pair(boxes[i], teamLabel);
         } else {
-            currentFrameBoxes[nextTrackingID++] = std::make_pair(boxes[i], teamLabel);
+            matchedTrackID = state.nextTrackingID++;
+            currentFrameBoxes[matchedTrackID] = std::make_pair(boxes[i], teamLabel);
         }
+        if(trackIds) trackIds->push_back(matchedTrackID);
 
         classifiedPlayers.push_back(std::make_pair(boxes[i], teamLabel));
     }
 
-    previousFrameBoxes = currentFrameBoxes;
+    state.previousFrameBoxes = currentFrameBoxes;
     return classifiedPlayers;
 }
+
+// resetPlayerTracking — Forget the previous frame's boxes after a shot cut so
+// that nearest-neighbor label smoothing does not match players across
+// unrelated camera views. Team anchors are kept: the kits do not change.
+void resetPlayerTracking(){
+    resetPlayerTracking(defaultClassifierState);
+}
+
+void resetPlayerTracking(TeamClassifierState &state){
+    state.previousFrameBoxes.clear();
+}
@@ -9,6 +9,36 @@
 #ifndef TEAM_CLASSIFICATION_H
 #define TEAM_CLASSIFICATION_H
 #include <opencv2/opencv.hpp>
+#include <map>
+#include <string>
 #include <vector>
-std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame,const std::vector<cv::Rect> &boxes);
+#include "detector_profile.h"
+
+// Everything classifyPlayers carries from one frame to the next: temporal team
+// anchors, the previous frame's tracked boxes, and the random state used by
+// k-means, so a stream can be checkpointed or run next to other streams.
+struct TeamClassifierState {
+    std::vector<cv::Mat> teamFeatureAnchors;
+    int anchorFrameCount;
+    bool teamAnchorsInitialized;
+    std::map<int, std::pair<cv::Rect,int> > previousFrameBoxes;
+    int nextTrackingID;
+    cv::uint64 rngState;
+
+    TeamClassifierState() : anchorFrameCount(0), teamAnchorsInitialized(false), nextTrackingID(0),
+                            rngState(cv::RNG().state) {}
+};
+
+std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame,const std::vector<cv::Rect> &boxes,
+                                                       std::vector<int> *trackIds = 0);
+std::vector<std::pair<cv::Rect,int> > classifyPlayers(const cv::Mat &frame,const std::vector<cv::Rect> &boxes,
+                                                       TeamClassifierState &state, std::vector<int> *trackIds = 0);
+std::vector<cv::Vec3f> extractPlayerFeatures(const cv::Mat &frame, const std::vector<cv::Rect> &boxes,
+                                             const DetectorParams &params = defaultDetectorParams());
+std::vector<std::pair<cv::Rect,int> > classifyPlayerFeatures(const std::vector<cv::Rect> &boxes,
+                                                              const std::vector<cv::Vec3f> &playerFeatures,
+                                                              TeamClassifierState &state, std::vector<int> *trackIds = 0);
+std::string featureStageSignature(const DetectorParams &params = defaultDetectorParams());
+void resetPlayerTracking();
+void resetPlayerTracking(TeamClassifierState &state);
 #endif
@@ -0,0 +1,156 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "video_export.h"
+#include <iostream>
+
+// Refresh interval (in exported frames) of the live heatmap overlay; blurring
+// the accumulator is too expensive to redo on every frame.
+static const int HEATMAP_REFRESH_FRAMES = 25;
+
+// drawPlayerAnnotations — Same color convention as the heatmap:
+// Team A = red, Team B = blue, Unknown = green (BGR format).
+void drawPlayerAnnotations(cv::Mat &image, const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers,
+                           const std::vector<int> &trackIds, double scale){
+    static const cv::Scalar teamDrawColors[3] = {
+        cv::Scalar(0, 0, 255), cv::Scalar(255, 0, 0), cv::Scalar(0, 255, 0)
+    };
+
+    for(size_t i = 0; i < classifiedPlayers.size(); i++){
+        cv::Rect box = classifiedPlayers[i].first;
+        if(scale != 1.0)
+            box = cv::Rect(cvRound(box.x * scale), cvRound(box.y * scale),
+                           cvRound(box.width * scale), cvRound(box.height * scale));
+        int teamLabel = classifiedPlayers[i].second;
+        int colorIndex = (teamLabel == 0 || teamLabel == 1) ? teamLabel : 2;
+
+        cv::rectangle(image, box, teamDrawColors[colorIndex], 2);
+
+        std::string labelText = (teamLabel == 0) ? "Team A" :
+                                (teamLabel == 1) ? "Team B" : "Unknown";
+        if(i < trackIds.size()) labelText += " #" + std::to_string(trackIds[i]);
+        cv::putText(image, labelText, box.tl() + cv::Point(0, -5),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.5, teamDrawColors[colorIndex], 1);
+    }
+}
+
+VideoExporter::VideoExporter(const ExportSettings &exportSettings)
+    : settings(exportSettings), stopping(false), framesWritten(0), writerFailed(false), queueWaits(0){
+    if(settings.everyNthFrame < 1) settings.everyNthFrame = 1;
+    if(settings.scale <= 0.0 || settings.scale > 1.0) settings.scale = 1.0;
+    if(settings.queueCapacity < 1) settings.queueCapacity = 1;
+
+    worker = std::thread(&VideoExporter::run, this);
+}
+
+VideoExporter::~VideoExporter(){
+    finish();
+}
+
+// submit — Called from the analysis loop. Decimated-out frames return
+// immediately; otherwise a reference to the frame is queued. Blocks only when
+// queueCapacity frames are already waiting to be encoded.
+void VideoExporter::submit(int frameIndex, const FrameRef &frame,
+                           const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers,
+                           const std::vector<int> &trackIds){
+    if(frameIndex % settings.everyNthFrame != 0) return;
+
+    ExportJob job;
+    job.frameIndex = frameIndex;
+    job.frame = frame;
+    job.players = classifiedPlayers;
+    job.trackIds = trackIds;
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if(stopping) return;
+        if((int)pendingJobs.size() >= settings.queueCapacity){
+            queueWaits++;
+            queueHasRoom.wait(lock, [this]{ return (int)pendingJobs.size() < settings.queueCapacity; });
+        }
+        pendingJobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+// finish — Drain the queue, close the video file and print export statistics.
+void VideoExporter::finish(std::ostream &out){
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if(stopping) return;
+        stopping = true;
+    }
+    jobAvailable.notify_one();
+    if(worker.joinable()) worker.join();
+
+    writer.release();
+    out << "Export: wrote " << framesWritten << " frames to " << settings.path
+        << " (" << queueWaits << " waits for queue room)\n";
+}
+
+void VideoExporter::run(){
+    for(;;){
+        ExportJob job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            jobAvailable.wait(lock, [this]{ return stopping || !pendingJobs.empty(); });
+            if(pendingJobs.empty()) return;
+            job = std::move(pendingJobs.front());
+            pendingJobs.pop_front();
+        }
+        queueHasRoom.notify_one();
+
+        encode(job);
+    }
+}
+
+// encode — Runs on the export thread: downscale for previews, accumulate and
+// blend the live heatmap, draw annotations and hand the frame to the encoder.
+// The shared frame is only read; everything is drawn on outputFrame, whose
+// buffer is reused from frame to frame.
+void VideoExporter::encode(ExportJob &job){
+    if(writerFailed) return;
+
+    const cv::Mat &sourceFrame = job.frame.image();
+    if(settings.scale != 1.0)
+        cv::resize(sourceFrame, outputFrame, cv::Size(), settings.scale, settings.scale, cv::INTER_AREA);
+    else
+        sourceFrame.copyTo(outputFrame);
+    job.frame.reset();
+
+    if(!writer.isOpened()){
+        // MJPG for AVI containers, MPEG-4 Part 2 otherwise (MP4).
+        std::string extension = settings.path.size() >= 4 ? settings.path.substr(settings.path.size() - 4) : "";
+        int fourcc = (extension == ".avi" || extension == ".AVI")
+            ? cv::VideoWriter::fourcc('M','J','P','G')
+            : cv::VideoWriter::fourcc('m','p','4','v');
+        double outputFps = settings.fps / settings.everyNthFrame;
+        if(!writer.open(settings.path, fourcc, outputFps, outputFrame.size())){
+            std::cerr << "Export: could not open " << settings.path << " for writing\n";
+            writerFailed = true;
+            return;
+        }
+    }
+
+    if(settings.heatmapOverlay){
+        std::vector<std::pair<cv::Rect,int> > scaledPlayers = job.players;
+        for(size_t i = 0; i < scaledPlayers.size(); i++){
+            cv::Rect &box = scaledPlayers[i].first;
+            box = cv::Rect(cvRound(box.x * settings.scale), cvRound(box.y * settings.scale),
+                           cvRound(box.width * settings.scale), cvRound(box.height * settings.scale));
+        }
+        liveHeatmap.update(outputFrame, scaledPlayers);
+        if(framesWritten % HEATMAP_REFRESH_FRAMES == 0)
+            liveHeatmap.render(heatmapImage);
+        if(!heatmapImage.empty())
+            cv::addWeighted(outputFrame, 0.7, heatmapImage, 0.3, 0, outputFrame);
+    }
+
+    drawPlayerAnnotations(outputFrame, job.players, job.trackIds, settings.scale);
+    writer.write(outputFrame);
+    framesWritten++;
+}
@@ -0,0 +1,84 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef VIDEO_EXPORT_H
+#define VIDEO_EXPORT_H
+
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "frame_pool.h"
+#include "player_heatmap.h"
+
+// Draw team-colored boxes, team labels and (optionally) tracking IDs. Box
+// coordinates are multiplied by scale so the same results can be drawn on a
+// downscaled copy of the frame.
+void drawPlayerAnnotations(cv::Mat &image, const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers,
+                           const std::vector<int> &trackIds, double scale = 1.0);
+
+struct ExportSettings {
+    std::string path;
+    double fps;
+    int everyNthFrame;     // preview decimation, 1 = every frame
+    double scale;          // preview downscale, 1.0 = native resolution
+    bool heatmapOverlay;
+    int queueCapacity;     // frames waiting to be encoded, bounds the queue
+
+    ExportSettings() : fps(25.0), everyNthFrame(1), scale(1.0), heatmapOverlay(false), queueCapacity(8) {}
+};
+
+// VideoExporter — Writes annotated frames to a video file from a background
+// thread. The analysis loop enqueues a reference to its pooled frame, without
+// copying; the export thread draws on its own scratch image and drops the
+// reference, which returns the frame slot to the pool.
+class VideoExporter {
+    struct ExportJob {
+        int frameIndex;
+        FrameRef frame;
+        std::vector<std::pair<cv::Rect,int> > players;
+        std::vector<int> trackIds;
+    };
+
+    ExportSettings settings;
+    std::deque<ExportJob> pendingJobs;
+    std::mutex queueMutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable queueHasRoom;
+    bool stopping;
+    std::thread worker;
+
+    // Owned by the export thread.
+    cv::VideoWriter writer;
+    Heatmap liveHeatmap;
+    cv::Mat outputFrame;
+    cv::Mat heatmapImage;
+    int framesWritten;
+    bool writerFailed;
+
+    // Number of submits that had to wait for room in the queue.
+    int queueWaits;
+
+    void run();
+    void encode(ExportJob &job);
+
+public:
+    explicit VideoExporter(const ExportSettings &exportSettings);
+    ~VideoExporter();
+    void submit(int frameIndex, const FrameRef &frame,
+                const std::vector<std::pair<cv::Rect,int> > &classifiedPlayers,
+                const std::vector<int> &trackIds);
+    void finish(std::ostream &out = std::cout);
+};
+
+#endif
@@ -0,0 +1,161 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#include "work_stealing_pool.h"
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+// Worker identity of the calling thread, so submit() can push locally.
+static thread_local WorkStealingPool *currentPool = 0;
+static thread_local int currentWorker = -1;
+
+WorkStealingPool::WorkStealingPool(int workerCount)
+    : pendingTasks(0), nextQueue(0), stopping(false), busyNanoseconds(0), stolenTasks(0), completedTasks(0){
+    if(workerCount < 1) workerCount = 1;
+    for(int i = 0; i < workerCount; i++) queues.emplace_back(new WorkerQueue());
+    for(int i = 0; i < workerCount; i++) workers.emplace_back(&WorkStealingPool::run, this, i);
+}
+
+// Runs every task already submitted, including tasks those tasks submit,
+// before the workers exit.
+WorkStealingPool::~WorkStealingPool(){
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for(size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+int WorkStealingPool::workerCount() const{
+    return (int)workers.size();
+}
+
+void WorkStealingPool::submit(Task task){
+    int target = (currentPool == this) ? currentWorker : (int)(nextQueue++ % queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        // Counted under the sleep mutex so a worker checking for work before
+        // waiting cannot miss it.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pendingTasks++;
+    }
+    taskAvailable.notify_one();
+}
+
+bool WorkStealingPool::popLocal(int worker, Task &task){
+    WorkerQueue &queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, Task &task){
+    for(size_t offset = 1; offset < queues.size(); offset++){
+        WorkerQueue &victim = *queues[(thief + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        stolenTasks++;
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int worker){
+    currentPool = this;
+    currentWorker = worker;
+    Task task;
+    for(;;){
+        if(popLocal(worker, task) || steal(worker, task)){
+            pendingTasks--;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            try {
+                task();
+            } catch(const std::exception &e){
+                std::cerr << "Worker " << worker << ": task failed: " << e.what() << "\n";
+            } catch(...){
+                std::cerr << "Worker " << worker << ": task failed\n";
+            }
+            busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            completedTasks++;
+            task = Task();
+            continue;
+        }
+
+        // No work anywhere: sleep until a submit, or exit once stopping and
+        // nothing is left. A task counted but not yet visible in a deque
+        // just makes the loop retry.
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        taskAvailable.wait(lock, [this]{ return pendingTasks > 0 || stopping; });
+        if(stopping && pendingTasks <= 0) return;
+    }
+}
+
+double WorkStealingPool::busySeconds() const{
+    return busyNanoseconds * 1e-9;
+}
+
+long WorkStealingPool::stealCount() const{
+    return stolenTasks;
+}
+
+long WorkStealingPool::taskCount() const{
+    return completedTasks;
+}
+
+Strand::Strand(WorkStealingPool &workerPool) : pool(workerPool), scheduled(false) {}
+
+void Strand::post(WorkStealingPool::Task task){
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+        if(!scheduled){
+            scheduled = true;
+            schedule = true;
+        }
+    }
+    if(schedule) pool.submit([this]{ runNext(); });
+}
+
+void Strand::runNext(){
+    WorkStealingPool::Task task;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = std::move(tasks.front());
+        tasks.pop_front();
+    }
+    try {
+        task();
+    } catch(...){
+        // Keep the strand alive for the tasks queued behind this one; the
+        // pool reports the failure.
+        reschedule();
+        throw;
+    }
+    reschedule();
+}
+
+void Strand::reschedule(){
+    bool more;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        more = !tasks.empty();
+        if(!more) scheduled = false;
+    }
+    if(more) pool.submit([this]{ runNext(); });
+}
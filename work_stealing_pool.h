@@ -0,0 +1,83 @@
+/********************************************************************************
+  Project: Sport Video Analysis
+  Author: Rajmonda Bardhi (Student ID: 2071810)
+  Course: Computer Vision — University of Padova
+  Instructor: Prof. Stefano Ghidoni
+  Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
+         No external source code beyond standard libraries and OpenCV.
+********************************************************************************/
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WorkStealingPool — Fixed set of worker threads, each with its own task
+// deque. A worker runs its newest local task first (cache-warm follow-up
+// work) and, when it has none, steals the oldest task of another worker.
+// Tasks submitted from a worker thread go to that worker's deque; tasks from
+// outside are spread round-robin.
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue> > queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable taskAvailable;
+    std::atomic<long> pendingTasks;
+    std::atomic<unsigned> nextQueue;
+    std::atomic<bool> stopping;
+
+    std::atomic<long long> busyNanoseconds;
+    std::atomic<long> stolenTasks;
+    std::atomic<long> completedTasks;
+
+    bool popLocal(int worker, Task &task);
+    bool steal(int thief, Task &task);
+    void run(int worker);
+
+public:
+    explicit WorkStealingPool(int workerCount);
+    ~WorkStealingPool();
+    void submit(Task task);
+    int workerCount() const;
+
+    // Time spent inside tasks, summed over workers, for utilization reports.
+    double busySeconds() const;
+    long stealCount() const;
+    long taskCount() const;
+};
+
+// Strand — Runs the tasks posted to it one at a time, in posting order, on a
+// WorkStealingPool. Tasks of different strands run in parallel. Each pool task
+// runs a single strand task and re-submits the strand if more are queued, so a
+// busy strand cannot monopolise a worker. The strand must outlive the pool's
+// execution of its tasks.
+class Strand {
+    WorkStealingPool &pool;
+    std::mutex mutex;
+    std::deque<WorkStealingPool::Task> tasks;
+    bool scheduled;
+
+    void runNext();
+    void reschedule();
+
+public:
+    explicit Strand(WorkStealingPool &workerPool);
+    void post(WorkStealingPool::Task task);
+};
+
+#endif
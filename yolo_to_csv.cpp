@@ -6,71 +6,423 @@
   Notes: Original work by the author. Built with C++17 and OpenCV on the official Virtual Lab.
          No external source code beyond standard libraries and OpenCV.
 ********************************************************************************/
+// yolo_to_csv.cpp
+// Usage: ./yolo_to_csv <labels_dir> <video_path | WxH> [out=yolo.csv] [--threads N]
+// Converts per-frame YOLO label files (class xc yc w h, normalized) into the
+// frame,x1,y1,x2,y2 CSV used by detection_evaluator, person class only. An
+// output path ending in .svdb writes the binary columnar format instead.
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <regex>
+#include <mutex>
+#include <thread>
 #include <vector>
+#include "detection_io.h"
 namespace fs = std::filesystem;
 
-int main(int argc, char **argv)
+struct LabelFile
+{
+    int frame;
+    fs::path path;
+};
+
+struct LabelRow
+{
+    int frame;
+    Box box;
+};
+
+// Files are parsed in contiguous chunks of the frame-ordered list; each chunk
+// keeps its rows in order, so the output is the concatenation of the chunks.
+// Chunks are written as soon as their predecessors are, and at most
+// CHUNKS_AHEAD_PER_THREAD per thread are parsed ahead of the writer, so
+// memory does not grow with the dataset.
+static const size_t FILES_PER_CHUNK = 256;
+static const size_t CHUNKS_AHEAD_PER_THREAD = 2;
+
+// First run of digits in the file name, as with the regex "(\d+)".
+static bool parse_frame_index(const std::string &fname, int &frame)
 {
-    if (argc < 3)
+    const char *p = fname.data();
+    const char *end = p + fname.size();
+    while (p < end && (*p < '0' || *p > '9'))
+        ++p;
+    if (p == end)
+        return false;
+    return std::from_chars(p, end, frame).ec == std::errc();
+}
+
+static inline const char *skip_blanks(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+    return p;
+}
+
+// Parse "cls xc yc w h [...]" lines of one label file already in memory.
+static void parse_labels(const char *p, const char *end, int frame, double W, double H,
+                         std::vector<LabelRow> &rows)
+{
+    while (p < end)
     {
-        std::cerr << "Usage: " << argv[0] << " <labels_dir> <video_path> [out_csv=yolo.csv]\n";
-        return 1;
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+
+        int cls = -1;
+        double v[4];
+        const char *q = skip_blanks(p, eol);
+        bool ok = q < eol;
+        if (ok)
+        {
+            auto r = std::from_chars(q, eol, cls);
+            ok = r.ec == std::errc();
+            q = r.ptr;
+        }
+        for (int k = 0; ok && k < 4; ++k)
+        {
+            q = skip_blanks(q, eol);
+            auto r = std::from_chars(q, eol, v[k]);
+            ok = r.ec == std::errc();
+            q = r.ptr;
+        }
+        if (ok && cls == 0) // keep 'person' only
+        {
+            const double xc = v[0], yc = v[1], w = v[2], h = v[3];
+            rows.push_back(LabelRow{frame, Box{(xc - w / 2.0) * W, (yc - h / 2.0) * H,
+                                               (xc + w / 2.0) * W, (yc + h / 2.0) * H}});
+        }
+        p = eol + 1;
+    }
+}
+
+static uint32_t read_be32(const unsigned char *p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+static uint32_t read_le32(const unsigned char *p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// Walk MP4/MOV boxes in [begin, end) looking for the first track header
+// (moov/trak/tkhd) with a non-zero size, i.e. the video track.
+static bool find_mp4_size(std::ifstream &in, uint64_t begin, uint64_t end, double &W, double &H)
+{
+    uint64_t pos = begin;
+    while (pos + 8 <= end)
+    {
+        unsigned char hdr[16];
+        in.seekg((std::streamoff)pos);
+        in.read(reinterpret_cast<char *>(hdr), 8);
+        if (!in)
+            return false;
+        uint64_t size = read_be32(hdr);
+        const std::string type(reinterpret_cast<char *>(hdr + 4), 4);
+        uint64_t header = 8;
+        if (size == 1)
+        {
+            in.read(reinterpret_cast<char *>(hdr + 8), 8);
+            if (!in)
+                return false;
+            size = (uint64_t(read_be32(hdr + 8)) << 32) | read_be32(hdr + 12);
+            header = 16;
+        }
+        else if (size == 0)
+            size = end - pos;
+        if (size < header || pos + size > end)
+            return false;
+
+        if (type == "moov" || type == "trak")
+        {
+            if (find_mp4_size(in, pos + header, pos + size, W, H))
+                return true;
+        }
+        else if (type == "tkhd")
+        {
+            unsigned char body[96];
+            const uint64_t body_len = std::min<uint64_t>(size - header, sizeof(body));
+            in.seekg((std::streamoff)(pos + header));
+            in.read(reinterpret_cast<char *>(body), (std::streamsize)body_len);
+            // version 0: width/height at 76, version 1 (64-bit times): at 88.
+            const size_t at = body[0] == 1 ? 88 : 76;
+            if (in && body_len >= at + 8)
+            {
+                const uint32_t w = read_be32(body + at) >> 16; // 16.16 fixed point
+                const uint32_t h = read_be32(body + at + 4) >> 16;
+                if (w > 0 && h > 0)
+                {
+                    W = w;
+                    H = h;
+                    return true;
+                }
+            }
+        }
+        pos += size;
+    }
+    return false;
+}
+
+// Read the frame size from the container headers only (MP4/MOV tkhd, AVI
+// avih), without opening a decoder.
+static bool probe_container_size(const std::string &video_path, double &W, double &H)
+{
+    std::ifstream in(video_path, std::ios::binary);
+    if (!in.is_open())
+        return false;
+    unsigned char head[72];
+    in.read(reinterpret_cast<char *>(head), sizeof(head));
+    const std::streamsize head_len = in.gcount();
+    if (head_len < 12)
+        return false;
+
+    if (std::memcmp(head, "RIFF", 4) == 0 && std::memcmp(head + 8, "AVI ", 4) == 0)
+    {
+        // RIFF AVI / LIST hdrl / avih: the avih payload starts at byte 32, with
+        // dwWidth and dwHeight at offsets 32 and 36 inside it.
+        if (head_len >= 72 && std::memcmp(head + 24, "avih", 4) == 0)
+        {
+            W = read_le32(head + 32 + 32);
+            H = read_le32(head + 32 + 36);
+            return W > 0 && H > 0;
+        }
+        return false;
+    }
+
+    in.clear();
+    in.seekg(0, std::ios::end);
+    const uint64_t file_size = (uint64_t)in.tellg();
+    return find_mp4_size(in, 0, file_size, W, H);
+}
+
+// Output in either format, fed one frame-ordered chunk at a time.
+class RowWriter
+{
+    bool binary = false;
+    std::ofstream csv;
+    BoxColumnWriter columns;
+
+public:
+    bool open(const std::string &out_path)
+    {
+        binary = out_path.size() >= 5 && out_path.compare(out_path.size() - 5, 5, ".svdb") == 0;
+        if (binary)
+            return columns.open(out_path);
+        csv.open(out_path, std::ios::binary);
+        if (!csv.is_open())
+            return false;
+        csv << "frame,x1,y1,x2,y2\n";
+        return (bool)csv;
+    }
+
+    void write(const std::vector<LabelRow> &rows)
+    {
+        if (binary)
+        {
+            for (const auto &r : rows)
+                columns.add(r.frame, r.box);
+            return;
+        }
+        // Same text as `out << double` with the default precision (%.6g).
+        char line[160];
+        for (const auto &r : rows)
+        {
+            char *p = line;
+            char *end = line + sizeof(line);
+            p = std::to_chars(p, end, r.frame).ptr;
+            const double v[4] = {r.box.x1, r.box.y1, r.box.x2, r.box.y2};
+            for (double x : v)
+            {
+                *p++ = ',';
+                p = std::to_chars(p, end, x, std::chars_format::general, 6).ptr;
+            }
+            *p++ = '\n';
+            csv.write(line, p - line);
+        }
     }
-    fs::path labels_dir = argv[1];
-    std::string video_path = argv[2];
-    std::string out_csv = (argc >= 4) ? argv[3] : "yolo.csv";
 
-    cv::VideoCapture cap(video_path);
-    if (!cap.isOpened())
+    bool close()
     {
-        std::cerr << "Cannot open video\n";
+        if (binary)
+            return columns.close();
+        csv.close();
+        return !csv.fail();
+    }
+};
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> positional;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            threads = (unsigned)std::max(1, std::atoi(argv[++i]));
+        else
+            positional.push_back(arg);
+    }
+    if (positional.size() < 2)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <labels_dir> <video_path | WxH> [out=yolo.csv|out.svdb] [--threads N]\n";
         return 1;
     }
-    const double W = cap.get(cv::CAP_PROP_FRAME_WIDTH);
-    const double H = cap.get(cv::CAP_PROP_FRAME_HEIGHT);
+    fs::path labels_dir = positional[0];
+    const std::string source = positional[1];
+    std::string out_csv = (positional.size() >= 3) ? positional[2] : "yolo.csv";
 
-    std::ofstream out(out_csv);
-    out << "frame,x1,y1,x2,y2\n";
+    // Frame size: explicit WxH, else container headers, else a decoder.
+    double W = 0, H = 0;
+    int w = 0, h = 0;
+    if (std::sscanf(source.c_str(), "%dx%d", &w, &h) == 2 && w > 0 && h > 0 &&
+        !fs::exists(source))
+    {
+        W = w;
+        H = h;
+    }
+    else if (!probe_container_size(source, W, H))
+    {
+        cv::VideoCapture cap(source);
+        if (!cap.isOpened())
+        {
+            std::cerr << "Cannot open video\n";
+            return 1;
+        }
+        W = cap.get(cv::CAP_PROP_FRAME_WIDTH);
+        H = cap.get(cv::CAP_PROP_FRAME_HEIGHT);
+    }
 
-    std::regex num_re("(\\d+)");
-    std::vector<fs::path> files;
+    std::vector<LabelFile> files;
+    size_t skipped_files = 0;
     for (auto &p : fs::directory_iterator(labels_dir))
-        if (p.is_regular_file() && p.path().extension() == ".txt")
-            files.push_back(p.path());
-    std::sort(files.begin(), files.end());
-
-    for (auto &p : files)
     {
-        std::smatch m;
-        std::string fname = p.filename().string();
-        if (!std::regex_search(fname, m, num_re))
+        if (!p.is_regular_file() || p.path().extension() != ".txt")
             continue;
-        int frame = std::stoi(m[1].str());
+        int frame;
+        if (parse_frame_index(p.path().filename().string(), frame))
+            files.push_back(LabelFile{frame, p.path()});
+        else
+        {
+            std::cerr << "Warning: skipping " << p.path().filename().string()
+                      << ": no frame number in the name (or too large)\n";
+            ++skipped_files;
+        }
+    }
+    // Numeric frame order (frame_2 before frame_10), name as tie-breaker.
+    std::sort(files.begin(), files.end(), [](const LabelFile &a, const LabelFile &b) {
+        return a.frame != b.frame ? a.frame < b.frame : a.path < b.path;
+    });
+
+    RowWriter writer;
+    if (!writer.open(out_csv))
+    {
+        std::cerr << "Cannot write " << out_csv << "\n";
+        return 1;
+    }
+
+    const size_t chunk_count = (files.size() + FILES_PER_CHUNK - 1) / FILES_PER_CHUNK;
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(1, chunk_count));
+    const size_t chunks_ahead = CHUNKS_AHEAD_PER_THREAD * threads;
+
+    // Parsed chunks waiting for the writer; entries are freed once written.
+    std::vector<std::vector<LabelRow>> chunks(chunk_count);
+    std::vector<char> parsed(chunk_count, 0);
+    size_t next_chunk = 0, next_to_write = 0, unreadable_files = 0;
+    std::mutex mutex;
+    std::condition_variable chunk_parsed, chunk_written;
+
+    auto worker = [&]() {
+        std::vector<char> buf; // reused across files
+        std::vector<LabelRow> rows;
+        for (;;)
+        {
+            size_t c;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                chunk_written.wait(lock, [&] {
+                    return next_chunk >= chunk_count || next_chunk < next_to_write + chunks_ahead;
+                });
+                if (next_chunk >= chunk_count)
+                    return;
+                c = next_chunk++;
+            }
+
+            const size_t first = c * FILES_PER_CHUNK;
+            const size_t last = std::min(files.size(), first + FILES_PER_CHUNK);
+            rows.clear();
+            for (size_t i = first; i < last; ++i)
+            {
+                std::ifstream in(files[i].path, std::ios::binary | std::ios::ate);
+                if (!in.is_open())
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    std::cerr << "Warning: cannot read " << files[i].path.string() << "\n";
+                    ++unreadable_files;
+                    continue;
+                }
+                const std::streamsize n = in.tellg();
+                if (n <= 0)
+                    continue;
+                buf.resize((size_t)n);
+                in.seekg(0);
+                in.read(buf.data(), n);
+                parse_labels(buf.data(), buf.data() + in.gcount(), files[i].frame, W, H, rows);
+            }
 
-        std::ifstream in(p);
-        std::string line;
-        while (std::getline(in, line))
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunks[c].swap(rows);
+                parsed[c] = 1;
+            }
+            chunk_parsed.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+        pool.emplace_back(worker);
+
+    // Write chunks in order on this thread while the workers parse ahead.
+    for (size_t c = 0; c < chunk_count; ++c)
+    {
+        std::vector<LabelRow> rows;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            chunk_parsed.wait(lock, [&] { return parsed[c] != 0; });
+            rows.swap(chunks[c]);
+        }
+        writer.write(rows);
         {
-            if (line.empty())
-                continue;
-            std::istringstream ss(line);
-            int cls;
-            double xc, yc, w, h;
-            ss >> cls >> xc >> yc >> w >> h;
-            if (cls != 0)
-                continue; // keep 'person' only
-            double x1 = (xc - w / 2.0) * W;
-            double y1 = (yc - h / 2.0) * H;
-            double x2 = (xc + w / 2.0) * W;
-            double y2 = (yc + h / 2.0) * H;
-            out << frame << "," << x1 << "," << y1 << "," << x2 << "," << y2 << "\n";
+            std::lock_guard<std::mutex> lock(mutex);
+            ++next_to_write;
         }
+        chunk_written.notify_all();
     }
-    std::cout << "Wrote " << out_csv << "\n";
+    for (auto &t : pool)
+        t.join();
+
+    if (!writer.close())
+    {
+        std::cerr << "Cannot write " << out_csv << "\n";
+        return 1;
+    }
+
+    std::cout << "Wrote " << out_csv << " (" << files.size() - unreadable_files << " label files, "
+              << threads << " threads";
+    if (skipped_files + unreadable_files > 0)
+        std::cout << "; skipped " << skipped_files << " without a frame number, " << unreadable_files
+                  << " unreadable";
+    std::cout << ")\n";
     return 0;
-}
\ No newline at end of file
+}